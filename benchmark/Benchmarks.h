@@ -0,0 +1,375 @@
+#ifndef __Benchmarks_h_
+#define __Benchmarks_h_
+
+// ITK
+#include "itkImage.h"
+#include "itkFixedArray.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkHessianRecursiveGaussianImageFilter.h"
+#include "itkSymmetricEigenAnalysisImageFilter.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkConnectedComponentImageFilter.h"
+#include "itkLabelShapeKeepNObjectsImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkBinaryFunctorImageFilter.h"
+#include "itkStatisticsImageFilter.h"
+
+// sheetness
+#include "KrcahSheetnessFeatureGenerator.h"
+#include "KrcahSheetnessFunctor.h"
+#include "KrcahBackgroundFunctor.h"
+#include "ModifiedSheetnessImageFilter.h"
+#include "AutomaticSheetnessParameterEstimationImageFilter.h"
+#include "TraceImageFilter.h"
+#include "FrobeniusNormImageFilter.h"
+#include "KrcahSheetnessImageFilter.h"
+#include "MaximumAbsoluteValueImageFilter.h"
+#include "BroadcastingBinaryFunctorImageFilter.h"
+#include "KrcahHessianSheetnessImageFilter.h"
+#include "PerformanceTelemetry.h"
+
+// graph cut
+#include "ImageGraphCut3DFilter.h"
+
+#include "BonePhantom.h"
+
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+/*
+ * Workloads shared by the benchmark executable and the performance regression tests.
+ * Every workload records its stages in the given telemetry object.
+ */
+namespace Benchmarks {
+    const unsigned int IMAGE_DIMENSION = 3;
+    typedef short InputPixelType;
+    typedef float SheetnessPixelType;
+    typedef unsigned char MaskPixelType;
+    typedef itk::Image<InputPixelType, IMAGE_DIMENSION> InputImageType;
+    typedef itk::Image<SheetnessPixelType, IMAGE_DIMENSION> SheetnessImageType;
+    typedef itk::Image<MaskPixelType, IMAGE_DIMENSION> MaskImageType;
+
+    typedef itk::HessianRecursiveGaussianImageFilter<InputImageType> HessianFilterType;
+    typedef HessianFilterType::OutputImageType HessianImageType;
+    typedef HessianImageType::PixelType HessianPixelType;
+    typedef itk::FixedArray<double, HessianPixelType::Dimension> EigenValueArrayType;
+    typedef itk::Image<EigenValueArrayType, IMAGE_DIMENSION> EigenValueImageType;
+    typedef itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType> EigenAnalysisFilterType;
+    typedef itk::KrcahHessianSheetnessImageFilter<HessianImageType, SheetnessImageType> HessianSheetnessFilterType;
+
+    typedef itk::KrcahSheetnessFeatureGenerator<InputImageType, SheetnessImageType> KrcahSheetnessFeatureGeneratorType;
+    typedef itk::AutomaticSheetnessParameterEstimationImageFilter<EigenValueImageType, MaskImageType> AutomaticSheetnessParameterEstimationImageFilterType;
+    typedef itk::ModifiedSheetnessImageFilter<EigenValueImageType, SheetnessImageType> ModifiedSheetnessImageFilterType;
+
+    // the dynamically scheduled filters
+    typedef itk::TraceImageFilter<HessianImageType, SheetnessImageType> TraceFilterType;
+    typedef itk::StatisticsImageFilter<SheetnessImageType> StatisticsFilterType;
+    typedef itk::FrobeniusNormImageFilter<HessianImageType, SheetnessImageType> FrobeniusNormFilterType;
+    typedef itk::KrcahSheetnessImageFilter<EigenValueImageType, double, SheetnessImageType> KrcahSheetnessFilterType;
+    typedef itk::MaximumAbsoluteValueImageFilter<SheetnessImageType, SheetnessImageType, SheetnessImageType> MaximumAbsoluteValueFilterType;
+    typedef itk::Functor::MaximumAbsoluteValue<SheetnessPixelType, SheetnessPixelType, SheetnessPixelType> MaximumAbsoluteValueFunctorType;
+    typedef itk::BroadcastingBinaryFunctorImageFilter<SheetnessImageType, SheetnessImageType, SheetnessImageType,
+            MaximumAbsoluteValueFunctorType> BroadcastingMaximumAbsoluteValueFilterType;
+
+    typedef unsigned long LabelPixelType;
+    typedef itk::Image<LabelPixelType, IMAGE_DIMENSION> LabelImageType;
+    typedef itk::BinaryThresholdImageFilter<InputImageType, LabelImageType> BinaryThresholdFilterType;
+    typedef itk::ConnectedComponentImageFilter<LabelImageType, LabelImageType> ConnectedComponentFilterType;
+    typedef itk::LabelShapeKeepNObjectsImageFilter<LabelImageType> KeepNObjectsFilterType;
+    typedef itk::CastImageFilter<LabelImageType, MaskImageType> LabelToMaskCastFilter;
+    typedef itk::Functor::KrcahBackground<InputPixelType, SheetnessPixelType, MaskPixelType> KrcahBackgroundFunctorType;
+    typedef itk::BinaryFunctorImageFilter<InputImageType, SheetnessImageType, MaskImageType, KrcahBackgroundFunctorType> NotBackgroundFilterType;
+    typedef itk::ImageGraphCut3DFilter<SheetnessImageType, MaskImageType, MaskImageType, MaskImageType> GraphCutFilterType;
+
+    // peak resident set size of this process in bytes
+    inline double getPeakResidentSetSize() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<double>(usage.ru_maxrss);
+#else
+        return static_cast<double>(usage.ru_maxrss) * 1024.0;
+#endif
+    }
+
+    // update a filter as one telemetry stage
+    template<typename TFilter>
+    void updateStage(itk::PerformanceTelemetry *telemetry, TFilter *filter, const std::string &stage) {
+        telemetry->StartStage(stage);
+        filter->Update();
+        telemetry->StopStage(stage, filter->GetOutput()->GetBufferedRegion().GetNumberOfPixels(),
+                             itk::PerformanceTelemetry::GetImageBufferSize(filter->GetOutput()),
+                             filter->GetNumberOfThreads());
+    }
+
+    // update a dynamically scheduled filter as one telemetry stage
+    template<typename TFilter>
+    void updateScheduledStage(itk::PerformanceTelemetry *telemetry, TFilter *filter, unsigned int chunksPerThread,
+                              const std::string &stage) {
+        filter->SetNumberOfChunksPerThread(chunksPerThread);
+        updateStage(telemetry, filter, stage);
+    }
+
+    inline InputImageType::Pointer generatePhantom(itk::PerformanceTelemetry *telemetry, unsigned int size,
+                                                   double noiseSigma) {
+        BonePhantom phantom;
+        phantom.SetNoiseSigma(noiseSigma);
+        telemetry->StartStage("phantom");
+        InputImageType::Pointer image = phantom.Generate<InputImageType>(size);
+        telemetry->StopStage("phantom", image->GetBufferedRegion().GetNumberOfPixels(),
+                             itk::PerformanceTelemetry::GetImageBufferSize(image.GetPointer()), 1);
+        return image;
+    }
+
+    // evaluate every functor on numberOfSamples random eigenvalue triplets / matrices
+    inline void runFunctors(itk::PerformanceTelemetry *telemetry, unsigned int numberOfSamples) {
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> eigenValue(-1000.0, 1000.0);
+        std::vector<EigenValueArrayType> eigenValues(numberOfSamples);
+        std::vector<HessianPixelType> hessians(numberOfSamples);
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            for (unsigned int j = 0; j < IMAGE_DIMENSION; ++j) {
+                eigenValues[i][j] = eigenValue(generator);
+            }
+            for (unsigned int j = 0; j < HessianPixelType::InternalDimension; ++j) {
+                hessians[i][j] = eigenValue(generator);
+            }
+        }
+
+        // keeps the compiler from removing the loops
+        volatile double sink = 0;
+
+        itk::Functor::KrcahSheetness<EigenValueArrayType, double, SheetnessPixelType> krcah;
+        telemetry->StartStage("functor: KrcahSheetness");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += krcah(eigenValues[i], 150.0);
+        }
+        telemetry->StopStage("functor: KrcahSheetness", numberOfSamples, 0, 1);
+
+        krcah.SetUseFastExp(true);
+        telemetry->StartStage("functor: KrcahSheetness FastExp");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += krcah(eigenValues[i], 150.0);
+        }
+        telemetry->StopStage("functor: KrcahSheetness FastExp", numberOfSamples, 0, 1);
+
+        // the batch path, as the filter calls it per scanline
+        const double traceMean = 150.0;
+        std::vector<SheetnessPixelType> batchOutput(numberOfSamples);
+        telemetry->StartStage("functor: KrcahSheetness batch FastExp");
+        krcah.Evaluate(&eigenValues[0], &traceMean, 0, &batchOutput[0], numberOfSamples);
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += batchOutput[i];
+        }
+        telemetry->StopStage("functor: KrcahSheetness batch FastExp", numberOfSamples, 0, 1);
+
+        itk::Functor::ModifiedSheetness<EigenValueArrayType, SheetnessPixelType> modified;
+        modified.SetC(100.0);
+        telemetry->StartStage("functor: ModifiedSheetness");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += modified(eigenValues[i]);
+        }
+        telemetry->StopStage("functor: ModifiedSheetness", numberOfSamples, 0, 1);
+
+        modified.SetUseFastExp(true);
+        telemetry->StartStage("functor: ModifiedSheetness FastExp");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += modified(eigenValues[i]);
+        }
+        telemetry->StopStage("functor: ModifiedSheetness FastExp", numberOfSamples, 0, 1);
+
+        itk::Functor::Trace<HessianPixelType, float> trace;
+        telemetry->StartStage("functor: Trace");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += trace(hessians[i]);
+        }
+        telemetry->StopStage("functor: Trace", numberOfSamples, 0, 1);
+
+        itk::Functor::MaximumAbsoluteValue<double, double, float> maximumAbsoluteValue;
+        telemetry->StartStage("functor: MaximumAbsoluteValue");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += maximumAbsoluteValue(eigenValues[i][0], eigenValues[i][1]);
+        }
+        telemetry->StopStage("functor: MaximumAbsoluteValue", numberOfSamples, 0, 1);
+
+        KrcahBackgroundFunctorType background;
+        telemetry->StartStage("functor: KrcahBackground");
+        for (unsigned int i = 0; i < numberOfSamples; ++i) {
+            sink += background(static_cast<InputPixelType>(eigenValues[i][0]), eigenValues[i][1]);
+        }
+        telemetry->StopStage("functor: KrcahBackground", numberOfSamples, 0, 1);
+    }
+
+    // Krcah sheetness, every stage of the generator is recorded
+    inline SheetnessImageType::Pointer runKrcahSheetness(itk::PerformanceTelemetry *telemetry,
+                                                         InputImageType *input,
+                                                         const KrcahSheetnessFeatureGeneratorType::SheetnessScalesType &scales) {
+        KrcahSheetnessFeatureGeneratorType::Pointer generator = KrcahSheetnessFeatureGeneratorType::New();
+        generator->SetInput(input);
+        generator->SetSheetnessScales(scales);
+        generator->SetTelemetry(telemetry);
+        updateStage(telemetry, generator.GetPointer(), "krcah sheetness");
+        return generator->GetOutput();
+    }
+
+    // Krcah sheetness with the intensity gate, as one stage next to "krcah sheetness". The Hessian still runs over
+    // the whole volume, the difference of the two stages is what the gate saves.
+    inline void runKrcahSheetnessGated(itk::PerformanceTelemetry *telemetry, InputImageType *input,
+                                       const KrcahSheetnessFeatureGeneratorType::SheetnessScalesType &scales) {
+        KrcahSheetnessFeatureGeneratorType::Pointer generator = KrcahSheetnessFeatureGeneratorType::New();
+        generator->SetInput(input);
+        generator->SetSheetnessScales(scales);
+        generator->SetUseIntensityGate(true);
+        updateStage(telemetry, generator.GetPointer(), "krcah sheetness gated");
+        telemetry->SetMetric("intensity gated fraction", generator->GetIntensityGatedFraction());
+    }
+
+    // Every dynamically scheduled filter, once with one chunk per thread (the static split) and once with the
+    // default dynamic chunks, the ratio of the "scheduling static" and "scheduling dynamic" stage of a filter is the
+    // gain from load balancing. T of the sheetness filters is the mean of the trace, C comes from the automatic
+    // parameter estimation. Only the fused sheetness with the low contrast skip leaves most of the work in the bone,
+    // the other filters do the same work per voxel and show the overhead of the finer chunks.
+    inline void runScheduling(itk::PerformanceTelemetry *telemetry, InputImageType *input, double sigma) {
+        HessianFilterType::Pointer hessian = HessianFilterType::New();
+        hessian->SetInput(input);
+        hessian->SetSigma(sigma);
+        hessian->Update();
+
+        EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+        eigen->SetDimension(IMAGE_DIMENSION);
+        eigen->SetInput(hessian->GetOutput());
+
+        AutomaticSheetnessParameterEstimationImageFilterType::Pointer scalerFilter = AutomaticSheetnessParameterEstimationImageFilterType::New();
+        scalerFilter->SetInput(eigen->GetOutput());
+        scalerFilter->Update();
+
+        // a value per slice, repeated along the first two axes
+        SheetnessImageType::Pointer sliceWeights = SheetnessImageType::New();
+        SheetnessImageType::SizeType sliceWeightsSize = {{1, 1, input->GetBufferedRegion().GetSize(2)}};
+        sliceWeights->SetRegions(sliceWeightsSize);
+        sliceWeights->Allocate();
+        sliceWeights->FillBuffer(0.5f);
+
+        const unsigned int chunksPerThread[] = {1, 16};
+        const std::string prefixes[] = {"scheduling static: ", "scheduling dynamic: "};
+        for (unsigned int i = 0; i < 2; ++i) {
+            TraceFilterType::Pointer trace = TraceFilterType::New();
+            trace->SetInput(hessian->GetOutput());
+            updateScheduledStage(telemetry, trace.GetPointer(), chunksPerThread[i], prefixes[i] + "trace");
+
+            StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+            statistics->SetInput(trace->GetOutput());
+            statistics->Update();
+            const double traceMean = statistics->GetMean();
+
+            FrobeniusNormFilterType::Pointer frobeniusNorm = FrobeniusNormFilterType::New();
+            frobeniusNorm->SetInput(hessian->GetOutput());
+            updateScheduledStage(telemetry, frobeniusNorm.GetPointer(), chunksPerThread[i],
+                                 prefixes[i] + "frobenius norm");
+
+            KrcahSheetnessFilterType::Pointer krcah = KrcahSheetnessFilterType::New();
+            krcah->SetInput(scalerFilter->GetOutput());
+            krcah->SetConstant(traceMean);
+            updateScheduledStage(telemetry, krcah.GetPointer(), chunksPerThread[i], prefixes[i] + "krcah sheetness");
+
+            HessianSheetnessFilterType::Pointer hessianSheetness = HessianSheetnessFilterType::New();
+            hessianSheetness->SetInput(hessian->GetOutput());
+            hessianSheetness->SetTraceMean(traceMean);
+            hessianSheetness->SetSkipThreshold(0.05);
+            updateScheduledStage(telemetry, hessianSheetness.GetPointer(), chunksPerThread[i],
+                                 prefixes[i] + "krcah hessian sheetness");
+
+            ModifiedSheetnessImageFilterType::Pointer modified = ModifiedSheetnessImageFilterType::New();
+            modified->SetInput(scalerFilter->GetOutput());
+            modified->DetectBrightSheetsOn();
+            modified->SetNormalization(scalerFilter->GetAlpha());
+            modified->SetNoiseNormalization(scalerFilter->GetC());
+            updateScheduledStage(telemetry, modified.GetPointer(), chunksPerThread[i],
+                                 prefixes[i] + "modified sheetness");
+
+            MaximumAbsoluteValueFilterType::Pointer maximumAbsoluteValue = MaximumAbsoluteValueFilterType::New();
+            maximumAbsoluteValue->SetInput1(krcah->GetOutput());
+            maximumAbsoluteValue->SetInput2(modified->GetOutput());
+            updateScheduledStage(telemetry, maximumAbsoluteValue.GetPointer(), chunksPerThread[i],
+                                 prefixes[i] + "maximum absolute value");
+
+            BroadcastingMaximumAbsoluteValueFilterType::Pointer broadcasting = BroadcastingMaximumAbsoluteValueFilterType::New();
+            broadcasting->SetInput1(maximumAbsoluteValue->GetOutput());
+            broadcasting->SetInput2(sliceWeights);
+            updateScheduledStage(telemetry, broadcasting.GetPointer(), chunksPerThread[i],
+                                 prefixes[i] + "broadcasting maximum absolute value");
+        }
+    }
+
+    // modified sheetness with automatic parameter estimation at a single scale
+    inline SheetnessImageType::Pointer runModifiedSheetness(itk::PerformanceTelemetry *telemetry,
+                                                            InputImageType *input, double sigma) {
+        HessianFilterType::Pointer hessian = HessianFilterType::New();
+        hessian->SetInput(input);
+        hessian->SetSigma(sigma);
+        updateStage(telemetry, hessian.GetPointer(), "modified: hessian");
+
+        EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+        eigen->SetDimension(IMAGE_DIMENSION);
+        eigen->SetInput(hessian->GetOutput());
+        updateStage(telemetry, eigen.GetPointer(), "modified: eigen analysis");
+
+        AutomaticSheetnessParameterEstimationImageFilterType::Pointer scalerFilter = AutomaticSheetnessParameterEstimationImageFilterType::New();
+        scalerFilter->SetInput(eigen->GetOutput());
+        scalerFilter->SetTelemetry(telemetry);
+        scalerFilter->Update();
+
+        ModifiedSheetnessImageFilterType::Pointer sheetnessFilter = ModifiedSheetnessImageFilterType::New();
+        sheetnessFilter->SetInput(scalerFilter->GetOutput());
+        sheetnessFilter->DetectBrightSheetsOn();
+        sheetnessFilter->SetNormalization(scalerFilter->GetAlpha());
+        sheetnessFilter->SetNoiseNormalization(scalerFilter->GetC());
+        updateStage(telemetry, sheetnessFilter.GetPointer(), "modified: sheetness");
+        return sheetnessFilter->GetOutput();
+    }
+
+    // exclusion masks of the Krcah example followed by the graph cut on the sheetness image
+    inline MaskImageType::Pointer runGraphCut(itk::PerformanceTelemetry *telemetry, InputImageType *input,
+                                              SheetnessImageType *sheetness) {
+        BinaryThresholdFilterType::Pointer thresholdFilter = BinaryThresholdFilterType::New();
+        thresholdFilter->SetUpperThreshold(-50);
+        thresholdFilter->SetInsideValue(255);
+        thresholdFilter->SetOutsideValue(0);
+        thresholdFilter->SetInput(input);
+
+        ConnectedComponentFilterType::Pointer connectedComponentFilter = ConnectedComponentFilterType::New();
+        connectedComponentFilter->SetInput(thresholdFilter->GetOutput());
+
+        KeepNObjectsFilterType::Pointer keepNObjectsFilter = KeepNObjectsFilterType::New();
+        keepNObjectsFilter->SetBackgroundValue(0);
+        keepNObjectsFilter->SetNumberOfObjects(1);
+        keepNObjectsFilter->SetAttribute(KeepNObjectsFilterType::LabelObjectType::NUMBER_OF_PIXELS);
+        keepNObjectsFilter->SetInput(connectedComponentFilter->GetOutput());
+
+        LabelToMaskCastFilter::Pointer notBoneFilter = LabelToMaskCastFilter::New();
+        notBoneFilter->SetInput(keepNObjectsFilter->GetOutput());
+        updateStage(telemetry, notBoneFilter.GetPointer(), "exclusion: not bone");
+
+        NotBackgroundFilterType::Pointer notBackgroundFilter = NotBackgroundFilterType::New();
+        notBackgroundFilter->SetInput1(input);
+        notBackgroundFilter->SetInput2(sheetness);
+        updateStage(telemetry, notBackgroundFilter.GetPointer(), "exclusion: not background");
+
+        GraphCutFilterType::Pointer graphCutFilter = GraphCutFilterType::New();
+        graphCutFilter->SetInputImage(sheetness);
+        graphCutFilter->SetForegroundImage(notBackgroundFilter->GetOutput());
+        graphCutFilter->SetBackgroundImage(notBoneFilter->GetOutput());
+        graphCutFilter->SetSigma(0.2);
+        graphCutFilter->SetLambda(5.0);
+        graphCutFilter->SetBoundaryDirectionTypeToBrightDark();
+        graphCutFilter->SetForegroundPixelValue(1);
+        graphCutFilter->SetBackgroundPixelValue(0);
+        graphCutFilter->SetTelemetry(telemetry);
+        updateStage(telemetry, graphCutFilter.GetPointer(), "graph cut");
+        return graphCutFilter->GetOutput();
+    }
+} // namespace Benchmarks
+
+#endif // __Benchmarks_h_
@@ -0,0 +1,112 @@
+#ifndef __BonePhantom_h_
+#define __BonePhantom_h_
+
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <cmath>
+#include <random>
+
+/*
+ * Procedural CT-like bone phantom in Hounsfield Units.
+ *
+ * The volume is tiled with cells of CellSize^3 voxels so that the amount of structure per voxel does not
+ * depend on the image size. Every cell contains
+ *  - a cortical shell (ellipsoidal sheet, ~2 voxels thick) around marrow,
+ *  - two trabecular rods (tubes) along x and z,
+ *  - a blob (Gaussian bump).
+ * Everything outside a cylinder around the z axis is air, so the 'not bone' exclusion region of the
+ * Krcah pipeline has a large connected component. Gaussian noise is added with a fixed seed.
+ */
+class BonePhantom {
+public:
+    static const int CellSize = 32;
+
+    static const short AirValue = -1000;
+    static const short SoftTissueValue = 40;
+    static const short MarrowValue = 60;
+    static const short CorticalValue = 1500;
+    static const short TrabecularValue = 700;
+    static const short BlobValue = 500;
+
+    BonePhantom() : m_NoiseSigma(20.0), m_Seed(0) {}
+
+    void SetNoiseSigma(double sigma) {
+        m_NoiseSigma = sigma;
+    }
+
+    void SetSeed(unsigned int seed) {
+        m_Seed = seed;
+    }
+
+    template<typename TImage>
+    typename TImage::Pointer Generate(unsigned int size) const {
+        typename TImage::Pointer image = TImage::New();
+        typename TImage::RegionType region;
+        typename TImage::SizeType imageSize;
+        imageSize.Fill(size);
+        region.SetSize(imageSize);
+        image->SetRegions(region);
+        image->Allocate();
+
+        std::mt19937 generator(m_Seed);
+        std::normal_distribution<double> noise(0.0, m_NoiseSigma);
+
+        const double center = 0.5 * (size - 1);
+        const double bodyRadius = 0.45 * size;
+
+        itk::ImageRegionIteratorWithIndex<TImage> it(image, region);
+        for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
+            const typename TImage::IndexType idx = it.GetIndex();
+
+            double value;
+            const double dx = idx[0] - center;
+            const double dy = idx[1] - center;
+            if (dx * dx + dy * dy > bodyRadius * bodyRadius) {
+                value = AirValue;
+            } else {
+                value = cellValue(idx[0] % CellSize, idx[1] % CellSize, idx[2] % CellSize);
+            }
+
+            if (m_NoiseSigma > 0) {
+                value += noise(generator);
+            }
+            it.Set(static_cast<typename TImage::PixelType>(value));
+        }
+        return image;
+    }
+
+private:
+    // value of a voxel at position (x,y,z) inside a cell
+    static double cellValue(double x, double y, double z) {
+        // cortical shell, ellipsoid with semi-axes 12, 10, 8 centered in the cell
+        const double ex = (x - 16) / 12.0;
+        const double ey = (y - 16) / 10.0;
+        const double ez = (z - 16) / 8.0;
+        const double r = std::sqrt(ex * ex + ey * ey + ez * ez);
+        const double shellDistance = (r - 1.0) * 10.0; // approximately in voxels
+        if (std::fabs(shellDistance) < 1.0) {
+            return CorticalValue;
+        }
+        if (r < 1.0) {
+            return MarrowValue;
+        }
+
+        // trabecular rods with a radius of 1.5 voxels
+        const double rodX = (y - 3) * (y - 3) + (z - 3) * (z - 3);
+        const double rodZ = (x - 3) * (x - 3) + (y - 29) * (y - 29);
+        if (rodX < 2.25 || rodZ < 2.25) {
+            return TrabecularValue;
+        }
+
+        // blob in the corner of the cell
+        const double bx = x - 28, by = y - 28, bz = z - 28;
+        const double blob = std::exp(-(bx * bx + by * by + bz * bz) / (2.0 * 3.0 * 3.0));
+        return SoftTissueValue + (BlobValue - SoftTissueValue) * blob;
+    }
+
+    double m_NoiseSigma;
+    unsigned int m_Seed;
+};
+
+#endif // __BonePhantom_h_
@@ -0,0 +1,125 @@
+#ifndef __PerformanceBaseline_h_
+#define __PerformanceBaseline_h_
+
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Stored reference numbers for the performance regression tests.
+ *
+ * One entry per line, '#' starts a comment:
+ *   <workload> <metric> <relative tolerance> <value> <stage name until the end of the line>
+ *
+ * metric is either voxels_per_s (a regression is a value below value * (1 - tolerance))
+ * or peak_rss_bytes (a regression is a value above value * (1 + tolerance)).
+ */
+class PerformanceBaseline {
+public:
+    struct Entry {
+        std::string Workload;
+        std::string Metric;
+        double Tolerance;
+        double Value;
+        std::string Stage;
+    };
+    typedef std::vector<Entry> EntryContainerType;
+
+    // returns false if the file does not exist
+    bool Read(const std::string &fileName) {
+        m_Entries.clear();
+        std::ifstream file(fileName.c_str());
+        if (!file) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream ss(line);
+            Entry entry;
+            if (!(ss >> entry.Workload >> entry.Metric >> entry.Tolerance >> entry.Value)) {
+                continue;
+            }
+            std::getline(ss >> std::ws, entry.Stage);
+            m_Entries.push_back(entry);
+        }
+        return true;
+    }
+
+    void Write(const std::string &fileName) const {
+        std::ofstream file(fileName.c_str());
+        file << "# Performance baseline, see benchmark/PerformanceBaseline.h for the format." << std::endl;
+        file << "# The numbers are machine specific, regenerate them with 'make update_perf_baseline'." << std::endl;
+        for (size_t i = 0; i < m_Entries.size(); ++i) {
+            const Entry &e = m_Entries[i];
+            file << e.Workload << " " << e.Metric << " " << e.Tolerance << " " << e.Value << " " << e.Stage << std::endl;
+        }
+    }
+
+    const Entry *Find(const std::string &workload, const std::string &metric, const std::string &stage) const {
+        for (size_t i = 0; i < m_Entries.size(); ++i) {
+            const Entry &e = m_Entries[i];
+            if (e.Workload == workload && e.Metric == metric && e.Stage == stage) {
+                return &e;
+            }
+        }
+        return 0;
+    }
+
+    bool HasWorkload(const std::string &workload) const {
+        for (size_t i = 0; i < m_Entries.size(); ++i) {
+            if (m_Entries[i].Workload == workload) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // add or replace an entry
+    void Set(const Entry &entry) {
+        for (size_t i = 0; i < m_Entries.size(); ++i) {
+            Entry &e = m_Entries[i];
+            if (e.Workload == entry.Workload && e.Metric == entry.Metric && e.Stage == entry.Stage) {
+                e = entry;
+                return;
+            }
+        }
+        m_Entries.push_back(entry);
+    }
+
+    // Tolerance of a voxels/s entry. The limit is 0.6 of the baseline, so a stage that runs twice as long fails, with
+    // 40% left for the noise of the fastest of the repeated runs.
+    static double GetVoxelsPerSecondTolerance() {
+        return 0.4;
+    }
+
+    // compares a measurement with its entry, prints the stage and returns false if it regressed
+    static bool Check(const Entry &entry, double measured, std::ostream &os) {
+        bool regressed;
+        double limit;
+        if (entry.Metric == "peak_rss_bytes") {
+            limit = entry.Value * (1.0 + entry.Tolerance);
+            regressed = measured > limit;
+        } else {
+            limit = entry.Value * (1.0 - entry.Tolerance);
+            regressed = measured < limit;
+        }
+        os << (regressed ? "REGRESSION " : "ok         ") << entry.Workload << " stage '" << entry.Stage << "' "
+           << entry.Metric << ": " << measured << " (baseline " << entry.Value << ", limit " << limit << ")"
+           << std::endl;
+        return !regressed;
+    }
+
+    const EntryContainerType &GetEntries() const {
+        return m_Entries;
+    }
+
+private:
+    EntryContainerType m_Entries;
+};
+
+#endif // __PerformanceBaseline_h_
@@ -0,0 +1,155 @@
+#include "Benchmarks.h"
+#include "PerformanceBaseline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Fixed-size workloads compared against a stored baseline, run through ctest with the 'perf' label.
+// Without a baseline for the workload the test is skipped, the exit code matches SKIP_RETURN_CODE in CMakeLists.txt.
+//
+// expected CLI call:
+// ./PerformanceRegressionTest functors|sheetness|graphcut size /path/to/baseline.txt [--update]
+const int SKIP_RETURN_CODE = 77;
+
+// Stages of a few milliseconds are dominated by timer resolution and scheduling noise. The workload is repeated until
+// every stage has run for MINIMUM_STAGE_TIME seconds in total, at most MAXIMUM_NUMBER_OF_REPEATS times, and each stage
+// is compared with its fastest run.
+const double MINIMUM_STAGE_TIME = 0.5;
+const unsigned int MAXIMUM_NUMBER_OF_REPEATS = 5;
+
+// the functor samples fit into memory for every size
+const unsigned int MAXIMUM_NUMBER_OF_FUNCTOR_SAMPLES = 1u << 21;
+
+void runWorkload(const std::string &workload, unsigned int size, itk::PerformanceTelemetry *telemetry,
+                 Benchmarks::InputImageType *phantom) {
+    if (workload == "functors") {
+        const itk::SizeValueType numberOfVoxels = static_cast<itk::SizeValueType>(size) * size * size;
+        Benchmarks::runFunctors(telemetry, static_cast<unsigned int>(
+                std::min<itk::SizeValueType>(numberOfVoxels, MAXIMUM_NUMBER_OF_FUNCTOR_SAMPLES)));
+        return;
+    }
+
+    Benchmarks::KrcahSheetnessFeatureGeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    if (workload == "sheetness") {
+        Benchmarks::runKrcahSheetness(telemetry, phantom, scales);
+    } else {
+        itk::PerformanceTelemetry::Pointer sheetnessTelemetry = itk::PerformanceTelemetry::New();
+        Benchmarks::SheetnessImageType::Pointer sheetness = Benchmarks::runKrcahSheetness(sheetnessTelemetry, phantom, scales);
+        Benchmarks::runGraphCut(telemetry, phantom, sheetness);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Verify arguments
+    if (argc != 4 && argc != 5) {
+        std::cerr << "Required: workload size baseline.txt [--update]" << std::endl;
+        std::cerr << "workload:      functors (the sheetness functors), sheetness (Krcah sheetness at 2 scales) or" << std::endl;
+        std::cerr << "               graphcut (sheetness + graph cut)" << std::endl;
+        std::cerr << "size:          edge length of the cubic bone phantom" << std::endl;
+        std::cerr << "baseline.txt:  stored voxels/s and peak memory per stage" << std::endl;
+        std::cerr << "--update:      write the measured values to the baseline instead of comparing" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string workload = argv[1];
+    const unsigned int size = atoi(argv[2]);
+    const std::string baselineFileName = argv[3];
+    const bool update = argc == 5 && std::string(argv[4]) == "--update";
+    if (workload != "functors" && workload != "sheetness" && workload != "graphcut") {
+        std::cerr << "Unknown workload " << workload << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // workload names in the baseline include the size so different sizes do not mix
+    std::ostringstream key;
+    key << workload << "_" << size;
+
+    // without reference numbers there is nothing to compare, skip before the workload runs
+    PerformanceBaseline baseline;
+    const bool hasBaseline = baseline.Read(baselineFileName);
+    if (!update && !hasBaseline) {
+        std::cout << "No baseline at " << baselineFileName << ", run with --update first." << std::endl;
+        return SKIP_RETURN_CODE;
+    }
+    if (!update && !baseline.HasWorkload(key.str())) {
+        std::cout << "The baseline has no entries for " << key.str() << ", run with --update first." << std::endl;
+        return SKIP_RETURN_CODE;
+    }
+
+    // the phantom is not part of the measured workload
+    Benchmarks::InputImageType::Pointer phantom;
+    if (workload != "functors") {
+        itk::PerformanceTelemetry::Pointer phantomTelemetry = itk::PerformanceTelemetry::New();
+        phantom = Benchmarks::generatePhantom(phantomTelemetry, size, 20.0);
+    }
+
+    // the fastest run of every stage, the stages are recorded in the same order in every run
+    itk::PerformanceTelemetry::StageRecordContainerType stages;
+    std::vector<double> totalWallTime;
+    for (unsigned int repeat = 0; repeat < MAXIMUM_NUMBER_OF_REPEATS; ++repeat) {
+        itk::PerformanceTelemetry::Pointer telemetry = itk::PerformanceTelemetry::New();
+        runWorkload(workload, size, telemetry, phantom);
+        const itk::PerformanceTelemetry::StageRecordContainerType &run = telemetry->GetStages();
+        if (stages.empty()) {
+            stages = run;
+            totalWallTime.assign(run.size(), 0);
+        }
+
+        double shortest = MINIMUM_STAGE_TIME;
+        for (size_t i = 0; i < stages.size() && i < run.size(); ++i) {
+            if (run[i].WallTime < stages[i].WallTime) {
+                stages[i] = run[i];
+            }
+            totalWallTime[i] += run[i].WallTime;
+            shortest = std::min(shortest, totalWallTime[i]);
+        }
+        if (shortest >= MINIMUM_STAGE_TIME) {
+            break;
+        }
+    }
+    const double peakResidentSetSize = Benchmarks::getPeakResidentSetSize();
+
+    if (update) {
+        for (size_t i = 0; i < stages.size(); ++i) {
+            PerformanceBaseline::Entry entry = {key.str(), "voxels_per_s",
+                    PerformanceBaseline::GetVoxelsPerSecondTolerance(),
+                    stages[i].GetVoxelsPerSecond(), stages[i].Name};
+            baseline.Set(entry);
+        }
+        PerformanceBaseline::Entry entry = {key.str(), "peak_rss_bytes", 0.2, peakResidentSetSize, "process"};
+        baseline.Set(entry);
+        baseline.Write(baselineFileName);
+        std::cout << "updated " << baselineFileName << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    bool passed = true;
+    unsigned int numberOfChecks = 0;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const PerformanceBaseline::Entry *entry = baseline.Find(key.str(), "voxels_per_s", stages[i].Name);
+        if (entry == ITK_NULLPTR) {
+            std::cout << "no baseline for " << key.str() << " stage '" << stages[i].Name << "'" << std::endl;
+            continue;
+        }
+        passed &= PerformanceBaseline::Check(*entry, stages[i].GetVoxelsPerSecond(), std::cout);
+        ++numberOfChecks;
+    }
+    const PerformanceBaseline::Entry *memory = baseline.Find(key.str(), "peak_rss_bytes", "process");
+    if (memory != ITK_NULLPTR) {
+        passed &= PerformanceBaseline::Check(*memory, peakResidentSetSize, std::cout);
+        ++numberOfChecks;
+    }
+
+    if (numberOfChecks == 0) {
+        std::cerr << "No stage of " << key.str() << " matches the baseline, run with --update." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,102 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// expected CLI call:
+// ./SheetnessBenchmark size /path/to/output.json [noiseSigma] [workloads]
+int main(int argc, char *argv[]) {
+    // Verify arguments
+    if (argc < 3 || argc > 5) {
+        std::cerr << "Required: size output.json [noiseSigma] [workloads]" << std::endl;
+        std::cerr << "size:         edge length of the cubic bone phantom, e.g. 64, 128, 256, 512 or 1024" << std::endl;
+        std::cerr << "output.json:  per-stage telemetry and peak resident set size" << std::endl;
+        std::cerr << "noiseSigma:   standard deviation of the added noise in HU, default 20" << std::endl;
+        std::cerr << "workloads:    comma separated subset of functors,krcah,gate,modified,graphcut,scheduling, default all." << std::endl;
+        std::cerr << "              graphcut needs krcah, the graph needs roughly 250 bytes per voxel." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const unsigned int size = atoi(argv[1]);
+    const std::string outputFileName = argv[2];
+    const double noiseSigma = argc > 3 ? atof(argv[3]) : 20.0;
+    const std::string workloads = argc > 4 ? argv[4] : "functors,krcah,gate,modified,graphcut,scheduling";
+    const bool runFunctors = workloads.find("functors") != std::string::npos;
+    const bool runKrcah = workloads.find("krcah") != std::string::npos;
+    const bool runModified = workloads.find("modified") != std::string::npos;
+    const bool runGraphCut = workloads.find("graphcut") != std::string::npos;
+    const bool runScheduling = workloads.find("scheduling") != std::string::npos;
+    const bool runGate = workloads.find("gate") != std::string::npos;
+
+    if (size == 0 || (runGraphCut && !runKrcah)) {
+        std::cerr << "Invalid size or workloads" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    itk::PerformanceTelemetry::Pointer telemetry = itk::PerformanceTelemetry::New();
+    telemetry->SetMetric("size", size);
+    telemetry->SetMetric("noise_sigma", noiseSigma);
+
+    std::cout << "generating " << size << "^3 phantom..." << std::endl;
+    Benchmarks::InputImageType::Pointer phantom = Benchmarks::generatePhantom(telemetry, size, noiseSigma);
+
+    if (runFunctors) {
+        // bounded so the samples fit into memory for the large phantoms
+        const unsigned int numberOfSamples = static_cast<unsigned int>(
+                std::min<itk::SizeValueType>(phantom->GetBufferedRegion().GetNumberOfPixels(), 1u << 24));
+        std::cout << "functors..." << std::endl;
+        Benchmarks::runFunctors(telemetry, numberOfSamples);
+    }
+
+    Benchmarks::SheetnessImageType::Pointer sheetness;
+    if (runKrcah) {
+        std::cout << "krcah sheetness..." << std::endl;
+        Benchmarks::KrcahSheetnessFeatureGeneratorType::SheetnessScalesType scales;
+        scales.push_back(0.75);
+        scales.push_back(1.0);
+        sheetness = Benchmarks::runKrcahSheetness(telemetry, phantom, scales);
+    }
+
+    if (runGate) {
+        std::cout << "krcah sheetness gated..." << std::endl;
+        Benchmarks::KrcahSheetnessFeatureGeneratorType::SheetnessScalesType scales;
+        scales.push_back(0.75);
+        scales.push_back(1.0);
+        Benchmarks::runKrcahSheetnessGated(telemetry, phantom, scales);
+    }
+
+    if (runModified) {
+        std::cout << "modified sheetness..." << std::endl;
+        Benchmarks::runModifiedSheetness(telemetry, phantom, 1.0);
+    }
+
+    if (runScheduling) {
+        std::cout << "scheduling..." << std::endl;
+        Benchmarks::runScheduling(telemetry, phantom, 1.0);
+    }
+
+    if (runGraphCut) {
+        std::cout << "graph cut..." << std::endl;
+        Benchmarks::runGraphCut(telemetry, phantom, sheetness);
+    }
+
+    telemetry->SetMetric("peak_rss_bytes", Benchmarks::getPeakResidentSetSize());
+
+    // summary
+    std::cout << std::endl << std::left << std::setw(50) << "stage" << std::right << std::setw(12) << "wall [s]"
+              << std::setw(16) << "voxels/s" << std::endl;
+    const itk::PerformanceTelemetry::StageRecordContainerType &stages = telemetry->GetStages();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        std::cout << std::left << std::setw(50) << stages[i].Name << std::right << std::setw(12) << stages[i].WallTime
+                  << std::setw(16) << stages[i].GetVoxelsPerSecond() << std::endl;
+    }
+    std::cout << "peak RSS: " << Benchmarks::getPeakResidentSetSize() / (1024.0 * 1024.0) << " MiB" << std::endl;
+
+    std::cout << "writing " << outputFileName << std::endl;
+    telemetry->WriteJSON(outputFileName);
+
+    return EXIT_SUCCESS;
+}
@@ -13,8 +13,8 @@
 #include "itkLabelStatisticsImageFilter.h"
 #include "itkShiftScaleImageFilter.h"
 
-#include "AutomaticSheetnessParameterEstimationImageFilter.h"
-#include "MaximumAbsoluteValueImageFilter.h"
+#include "EigenAnalysisWithParameterEstimationImageFilter.h"
+#include "NaryMaximumAbsoluteValueImageFilter.h"
 #include <vector>
 
 // Templating
@@ -37,7 +37,7 @@ typedef HessianImageType::PixelType                                 HessianPixel
 typedef  itk::FixedArray< double, HessianPixelType::Dimension >     EigenValueArrayType;
 typedef  itk::Image< EigenValueArrayType, IMAGE_DIMENSION >               EigenValueImageType;
 
-typedef  itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType>     EigenAnalysisFilterType;
+typedef  itk::EigenAnalysisWithParameterEstimationImageFilter<HessianImageType, EigenValueImageType, MaskImageType>     EigenAnalysisFilterType;
 typedef itk::DescoteauxSheetnessImageFilter< EigenValueImageType, SheetnessImageType >   DescoteauxSheetnessFilterType;
 
 typedef itk::BinaryThresholdImageFilter<InputImageType, MaskImageType> BinaryThresholdImageFilterType;
@@ -48,8 +48,7 @@ typedef itk::BinaryErodeImageFilter<MaskImageType, MaskImageType, StructuringEle
 typedef itk::LabelStatisticsImageFilter<InputImageType, MaskImageType> LabelStatisticsImageFilterType;
 typedef itk::ShiftScaleImageFilter<SheetnessImageType, SheetnessImageType> ShiftScaleImageFilterType;
 
-typedef itk::AutomaticSheetnessParameterEstimationImageFilter<EigenValueImageType, MaskImageType> AutomaticSheetnessParameterEstimationImageFilterType;
-typedef itk::MaximumAbsoluteValueImageFilter<SheetnessImageType, SheetnessImageType, SheetnessImageType> MaximumAbsoluteValueFilterType;
+typedef itk::NaryMaximumAbsoluteValueImageFilter<SheetnessImageType> MaximumAbsoluteValueFilterType;
 
 class ArgumentDatabase {
 public:
@@ -136,8 +135,8 @@ typename SheetnessImageType::Pointer calculateSheetnessAtScale(
     , double automaticSheetnessScale
     , int label = 1
 ) {
-    // Hessian + EigenAnalysis
-    std::cout << "Computing Hessian and performing Eigen-analysis" << std::endl;
+    // Hessian + EigenAnalysis, the scaling parameters are determined in the same pass
+    std::cout << "Computing Hessian, performing Eigen-analysis and determining scaling parameters" << std::endl;
     typename HessianFilterType::Pointer hessian = HessianFilterType::New();
     hessian->SetInput(inputFilePointer);
     hessian->SetSigma(sigma);
@@ -145,30 +144,24 @@ typename SheetnessImageType::Pointer calculateSheetnessAtScale(
     EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
     eigen->SetDimension(IMAGE_DIMENSION);
     eigen->SetInput(hessian->GetOutput());
+    eigen->SetLabelInput(maskFilePointer);
+    eigen->SetLabel(label);
+    eigen->SetScale(automaticSheetnessScale);
     eigen->Update();
 
-    // Get scaling parameters
-    std::cout << "Automatically determining scaling parameters" << std::endl;
-    typename AutomaticSheetnessParameterEstimationImageFilterType::Pointer scalerFilter = AutomaticSheetnessParameterEstimationImageFilterType::New();
-    scalerFilter->SetInput(eigen->GetOutput());
-    scalerFilter->SetLabelInput(maskFilePointer);
-    scalerFilter->SetLabel(label);
-    scalerFilter->SetScale(automaticSheetnessScale);
-    scalerFilter->Update();
-
     std::cout << "Determined Sheetness parameters: " << std::endl;
-    std::cout << "  Alpha " << scalerFilter->GetAlpha() << std::endl;
-    std::cout << "  Beta  " << scalerFilter->GetBeta() << std::endl;
-    std::cout << "  C     " << scalerFilter->GetC() << std::endl;
+    std::cout << "  Alpha " << eigen->GetAlpha() << std::endl;
+    std::cout << "  Beta  " << eigen->GetBeta() << std::endl;
+    std::cout << "  C     " << eigen->GetC() << std::endl;
 
     // compute sheetness
     std::cout << "Computing sheetness..." << std::endl;
     typename DescoteauxSheetnessFilterType::Pointer sheetnessFilter = DescoteauxSheetnessFilterType::New();
-    sheetnessFilter->SetInput(scalerFilter->GetOutput());
+    sheetnessFilter->SetInput(eigen->GetOutput());
     sheetnessFilter->SetDetectBrightSheets(true);
-    sheetnessFilter->SetSheetnessNormalization(scalerFilter->GetAlpha());
-    sheetnessFilter->SetBloobinessNormalization(scalerFilter->GetBeta());
-    sheetnessFilter->SetNoiseNormalization(scalerFilter->GetC());
+    sheetnessFilter->SetSheetnessNormalization(eigen->GetAlpha());
+    sheetnessFilter->SetBloobinessNormalization(eigen->GetBeta());
+    sheetnessFilter->SetNoiseNormalization(eigen->GetC());
     sheetnessFilter->Update();
 
     return sheetnessFilter->GetOutput();
@@ -209,37 +202,20 @@ int main(int argc, char *argv[]) {
     erosionFilter->SetErodeValue(1);
     erosionFilter->Update();
 
-    // Loop over sigmas, take maximum value
-    std::cout << "Current sigma: " << db.sigmas.at(0) << std::endl;
-    typename SheetnessImageType::Pointer sheetnessFilePointer = calculateSheetnessAtScale(
-         reader->GetOutput()
-        ,erosionFilter->GetOutput()
-        ,db.sigmas.at(0)
-        ,db.automaticSheetnessScale
-    );
-
-    if (db.sigmas.size() > 1) { // need for std::next()
-        for(ArgumentDatabase::TSigmas::const_iterator it = std::next(db.sigmas.begin()); it != db.sigmas.end(); ++it) {
-            std::cout << "Current sigma: " << *it << std::endl;
-
-            // Calculte the remaining (n-1) sheetnesses
-            typename SheetnessImageType::Pointer tempSheetnessFilePointer = calculateSheetnessAtScale(
-                 reader->GetOutput()
-                ,erosionFilter->GetOutput()
-                ,*it
-                ,db.automaticSheetnessScale
-            );
-
-            // Take abs max
-            typename MaximumAbsoluteValueFilterType::Pointer maximumAbsoluteValueFilter = MaximumAbsoluteValueFilterType::New();
-            maximumAbsoluteValueFilter->SetInput1(sheetnessFilePointer);
-            maximumAbsoluteValueFilter->SetInput2(tempSheetnessFilePointer);
-            maximumAbsoluteValueFilter->Update();
-
-            // Save max and move on
-            sheetnessFilePointer = maximumAbsoluteValueFilter->GetOutput();
-        }
+    // Loop over sigmas, take maximum value of all of them in one pass
+    typename MaximumAbsoluteValueFilterType::Pointer maximumAbsoluteValueFilter = MaximumAbsoluteValueFilterType::New();
+    for (ArgumentDatabase::TSigmas::size_type i = 0; i < db.sigmas.size(); ++i) {
+        std::cout << "Current sigma: " << db.sigmas.at(i) << std::endl;
+        maximumAbsoluteValueFilter->SetInput(i, calculateSheetnessAtScale(
+             reader->GetOutput()
+            ,erosionFilter->GetOutput()
+            ,db.sigmas.at(i)
+            ,db.automaticSheetnessScale
+        ));
     }
+    maximumAbsoluteValueFilter->InPlaceOn();
+    maximumAbsoluteValueFilter->Update();
+    typename SheetnessImageType::Pointer sheetnessFilePointer = maximumAbsoluteValueFilter->GetOutput();
 
     // Scale the image
     typename ShiftScaleImageFilterType::Pointer scaler = ShiftScaleImageFilterType::New();
@@ -13,7 +13,7 @@
 #include "itkLabelStatisticsImageFilter.h"
 #include "itkShiftScaleImageFilter.h"
 
-#include "AutomaticSheetnessParameterEstimationImageFilter.h"
+#include "EigenAnalysisWithParameterEstimationImageFilter.h"
 
 // Templating
 const unsigned int IMAGE_DIMENSION = 3;
@@ -35,7 +35,7 @@ typedef HessianImageType::PixelType                                 HessianPixel
 typedef  itk::FixedArray< double, HessianPixelType::Dimension >     EigenValueArrayType;
 typedef  itk::Image< EigenValueArrayType, IMAGE_DIMENSION >               EigenValueImageType;
 
-typedef  itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType>     EigenAnalysisFilterType;
+typedef  itk::EigenAnalysisWithParameterEstimationImageFilter<HessianImageType, EigenValueImageType, MaskImageType>     EigenAnalysisFilterType;
 typedef itk::DescoteauxSheetnessImageFilter< EigenValueImageType, SheetnessImageType >   DescoteauxSheetnessFilterType;
 
 typedef itk::BinaryThresholdImageFilter<InputImageType, MaskImageType> BinaryThresholdImageFilterType;
@@ -46,8 +46,6 @@ typedef itk::BinaryErodeImageFilter<MaskImageType, MaskImageType, StructuringEle
 typedef itk::LabelStatisticsImageFilter<InputImageType, MaskImageType> LabelStatisticsImageFilterType;
 typedef itk::ShiftScaleImageFilter<SheetnessImageType, SheetnessImageType> ShiftScaleImageFilterType;
 
-typedef itk::AutomaticSheetnessParameterEstimationImageFilter<EigenValueImageType, MaskImageType> AutomaticSheetnessParameterEstimationImageFilterType;
-
 
 int main(int argc, char *argv[]) {
     // Constants
@@ -114,8 +112,8 @@ int main(int argc, char *argv[]) {
     // thresFilter->ThresholdBelow(threshold);
     // thresFilter->Update();
 
-    // Hessian + EigenAnalysis
-    std::cout << "Computing Hessian and performing Eigen-analysis" << std::endl;
+    // Hessian + EigenAnalysis, the scaling parameters are determined in the same pass
+    std::cout << "Computing Hessian, performing Eigen-analysis and determining scaling parameters" << std::endl;
     typename HessianFilterType::Pointer hessian = HessianFilterType::New();
     hessian->SetInput(reader->GetOutput());
     hessian->SetSigma(sigma);
@@ -123,30 +121,24 @@ int main(int argc, char *argv[]) {
     EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
     eigen->SetDimension(IMAGE_DIMENSION);
     eigen->SetInput(hessian->GetOutput());
+    eigen->SetLabelInput(erosionFilter->GetOutput());
+    eigen->SetLabel(1);
+    eigen->SetScale(0.05f);
     eigen->Update();
 
-    // Get scaling parameters
-    std::cout << "Automatically determining scaling parameters" << std::endl;
-    typename AutomaticSheetnessParameterEstimationImageFilterType::Pointer scalerFilter = AutomaticSheetnessParameterEstimationImageFilterType::New();
-    scalerFilter->SetInput(eigen->GetOutput());
-    scalerFilter->SetLabelInput(erosionFilter->GetOutput());
-    scalerFilter->SetLabel(1);
-    scalerFilter->SetScale(0.05f);
-    scalerFilter->Update();
-
     std::cout << "Determined parameters: " << std::endl;
-    std::cout << "  Alpha " << scalerFilter->GetAlpha() << std::endl;
-    std::cout << "  Beta  " << scalerFilter->GetBeta() << std::endl;
-    std::cout << "  C     " << scalerFilter->GetC() << std::endl;
+    std::cout << "  Alpha " << eigen->GetAlpha() << std::endl;
+    std::cout << "  Beta  " << eigen->GetBeta() << std::endl;
+    std::cout << "  C     " << eigen->GetC() << std::endl;
 
     // compute sheetness
     std::cout << "Computing sheetness..." << std::endl;
     typename DescoteauxSheetnessFilterType::Pointer sheetnessFilter = DescoteauxSheetnessFilterType::New();
-    sheetnessFilter->SetInput(scalerFilter->GetOutput());
+    sheetnessFilter->SetInput(eigen->GetOutput());
     sheetnessFilter->SetDetectBrightSheets(true);
-    sheetnessFilter->SetSheetnessNormalization(scalerFilter->GetAlpha());
-    sheetnessFilter->SetBloobinessNormalization(scalerFilter->GetBeta());
-    sheetnessFilter->SetNoiseNormalization(scalerFilter->GetC());
+    sheetnessFilter->SetSheetnessNormalization(eigen->GetAlpha());
+    sheetnessFilter->SetBloobinessNormalization(eigen->GetBeta());
+    sheetnessFilter->SetNoiseNormalization(eigen->GetC());
     sheetnessFilter->Update();
 
     // Scale the image
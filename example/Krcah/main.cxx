@@ -5,6 +5,7 @@
 
 // sheetness
 #include "KrcahSheetnessFeatureGenerator.h"
+#include "PerformanceTelemetry.h"
 
 // exclude regions
 #include "itkBinaryThresholdImageFilter.h"
@@ -46,18 +47,18 @@ typedef itk::BinaryFunctorImageFilter<InputImageType, SheetnessImageType, MaskIm
 // functions
 FileReaderType::Pointer readImage(char *pathInput);
 
-SheetnessImageType::Pointer getSheetnessImage(InputImageType::Pointer input);
+SheetnessImageType::Pointer getSheetnessImage(InputImageType::Pointer input, itk::PerformanceTelemetry *telemetry);
 
 MaskImageType::Pointer getExclusionRegionNotBone(InputImageType::Pointer input);
 
 MaskImageType::Pointer getExclusionRegionNotBkg(InputImageType::Pointer input, SheetnessImageType::Pointer sheetness);
 
 // expected CLI call:
-// ./KrcahSheetness /path/to/input /path/to/outputSheetness /path/to/outputExclusionNotBone /path/to/outputExclusionNotBackground
+// ./KrcahSheetness /path/to/input /path/to/outputSheetness /path/to/outputExclusionNotBone /path/to/outputExclusionNotBackground [/path/to/telemetry.json]
 int main(int argc, char *argv[]) {
     // Verify arguments
-    if (argc != 5) {
-        std::cerr << "Required: inputImage.mhd outputSheetness.mhd outputBackground.mhd outputForeground.mhd" << std::endl;
+    if (argc != 5 && argc != 6) {
+        std::cerr << "Required: inputImage.mhd outputSheetness.mhd outputBackground.mhd outputForeground.mhd [telemetry.json]" << std::endl;
         std::cerr << "inputImage.mhd:        3D image in Hounsfield Units -1024 to 3071" << std::endl;
         std::cerr << "outputSheetness.mhd:   3D image sheetness results." << std::endl;
         std::cerr << "                       Pixeltype float, ranging from -1 to 1." << std::endl;
@@ -65,16 +66,22 @@ int main(int argc, char *argv[]) {
         std::cerr << "                       Pixeltype unsigned char, pixel value 1 indicating background." << std::endl;
         std::cerr << "outputForeground.mhd:  3D image foreground mask" << std::endl;
         std::cerr << "                       Pixeltype unsigned char, pixel value 1 indicating foreground." << std::endl;
+        std::cerr << "telemetry.json:        optional, per-stage timings of the sheetness computation." << std::endl;
         return EXIT_FAILURE;
     }
 
+    itk::PerformanceTelemetry::Pointer telemetry;
+    if (argc == 6) {
+        telemetry = itk::PerformanceTelemetry::New();
+    }
+
     // read input
     FileReaderType::Pointer inputReader = readImage(argv[1]);
     InputImageType::Pointer inputImage = inputReader->GetOutput();
 
     // generate sheetness
     std::cout << "generating sheetness..." << std::endl;
-    SheetnessImageType::Pointer sheetnessImage = getSheetnessImage(inputImage);
+    SheetnessImageType::Pointer sheetnessImage = getSheetnessImage(inputImage, telemetry);
 
     // first exclude region 'not bone'
     std::cout << "generating exlusion regions" << std::endl;
@@ -104,6 +111,11 @@ int main(int argc, char *argv[]) {
     writerExcludeNotBkg->SetInput(exclusionNotBkg);
     writerExcludeNotBkg->Update();
 
+    if (telemetry) {
+        std::cout << "writing telemetry" << std::endl;
+        telemetry->WriteJSON(std::string(argv[5]));
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -143,9 +155,10 @@ MaskImageType::Pointer getExclusionRegionNotBone(InputImageType::Pointer input)
     return castFilter->GetOutput();
 }
 
-SheetnessImageType::Pointer getSheetnessImage(InputImageType::Pointer input) {
+SheetnessImageType::Pointer getSheetnessImage(InputImageType::Pointer input, itk::PerformanceTelemetry *telemetry) {
     KrcahSheetnessFeatureGenerator::Pointer generator = KrcahSheetnessFeatureGenerator::New();
     generator->SetInput(input);
+    generator->SetTelemetry(telemetry);
     generator->Update();
     return generator->GetOutput();
 }
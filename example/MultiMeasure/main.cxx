@@ -0,0 +1,107 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+
+#include "itkHessianRecursiveGaussianImageFilter.h"
+#include "itkSymmetricEigenAnalysisImageFilter.h"
+
+#include "MeanTraceBoundaryFluxCalculator.h"
+#include "MultiMeasureSheetnessImageFilter.h"
+#include "KrcahSheetnessFunctor.h"
+#include "ModifiedSheetnessImageFilter.h"
+#include "DescoteauxSheetnessFunctor.h"
+
+// Templating
+const unsigned int IMAGE_DIMENSION = 3;
+typedef short InputPixelType;
+typedef float SheetnessPixelType;
+typedef itk::Image<InputPixelType, IMAGE_DIMENSION> InputImageType;
+typedef itk::Image<SheetnessPixelType, IMAGE_DIMENSION> SheetnessImageType;
+
+typedef itk::ImageFileReader<InputImageType> FileReaderType;
+typedef itk::ImageFileWriter<SheetnessImageType> SheetnessWriterType;
+
+typedef itk::HessianRecursiveGaussianImageFilter< InputImageType >  HessianFilterType;
+typedef HessianFilterType::OutputImageType                          HessianImageType;
+typedef HessianImageType::PixelType                                 HessianPixelType;
+
+typedef  itk::FixedArray< double, HessianPixelType::Dimension >     EigenValueArrayType;
+typedef  itk::Image< EigenValueArrayType, IMAGE_DIMENSION >               EigenValueImageType;
+
+typedef  itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType>     EigenAnalysisFilterType;
+typedef itk::MeanTraceBoundaryFluxCalculator<InputImageType> TraceMeanCalculatorType;
+typedef itk::MultiMeasureSheetnessImageFilter<EigenValueImageType, SheetnessImageType> MultiMeasureFilterType;
+
+typedef itk::Functor::KrcahSheetness<EigenValueArrayType, double, SheetnessPixelType> KrcahFunctorType;
+typedef itk::Functor::ModifiedSheetness<EigenValueArrayType, SheetnessPixelType> ModifiedFunctorType;
+typedef itk::Functor::DescoteauxSheetness<EigenValueArrayType, SheetnessPixelType> DescoteauxFunctorType;
+
+
+int main(int argc, char *argv[]) {
+    // Constants
+    double sigma = 1;
+    double c = 0.5;
+
+    // Verify arguments
+    if (argc != 6) {
+        std::cerr << "Required: inputImage.mhd krcah.mhd modified.mhd descoteaux.mhd sigma" << std::endl;
+        std::cerr << "inputImage.mhd:        3D image in Hounsfield Units -1024 to 3071" << std::endl;
+        std::cerr << "krcah.mhd:             3D image Krcah sheetness results." << std::endl;
+        std::cerr << "modified.mhd:          3D image modified sheetness results." << std::endl;
+        std::cerr << "descoteaux.mhd:        3D image Descoteaux sheetness results." << std::endl;
+        std::cerr << "sigma:                 Sigma value (double)" << std::endl;
+        return EXIT_FAILURE;
+    }
+    sigma = atof(argv[5]);
+
+    // read input
+    std::cout << "Reading input " << argv[1] << std::endl;
+    typename FileReaderType::Pointer reader = FileReaderType::New();
+    reader->SetFileName(argv[1]);
+    reader->Update();
+
+    // Hessian + EigenAnalysis, once for all measures
+    std::cout << "Computing Hessian and performing Eigen-analysis" << std::endl;
+    HessianFilterType::Pointer hessian = HessianFilterType::New();
+    hessian->SetInput(reader->GetOutput());
+    hessian->SetSigma(sigma);
+
+    EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+    eigen->SetDimension(IMAGE_DIMENSION);
+    eigen->SetInput(hessian->GetOutput());
+
+    // mean trace for the noise term of Krcah
+    TraceMeanCalculatorType::Pointer traceMean = TraceMeanCalculatorType::New();
+    traceMean->SetImage(reader->GetOutput());
+    traceMean->SetSigma(sigma);
+    traceMean->Compute();
+
+    // all measures in one traversal of the eigenvalues
+    std::cout << "Computing sheetness..." << std::endl;
+    MultiMeasureFilterType::Pointer sheetnessFilter = MultiMeasureFilterType::New();
+    sheetnessFilter->SetInput(eigen->GetOutput());
+
+    KrcahFunctorType krcah;
+    const unsigned int krcahIndex = sheetnessFilter->AddMeasure(krcah, traceMean->GetMean());
+
+    ModifiedFunctorType modified;
+    modified.SetC(c);
+    const unsigned int modifiedIndex = sheetnessFilter->AddMeasure(modified);
+
+    DescoteauxFunctorType descoteaux;
+    descoteaux.SetC(c);
+    const unsigned int descoteauxIndex = sheetnessFilter->AddMeasure(descoteaux);
+
+    sheetnessFilter->Update();
+
+    // write outputs
+    const unsigned int indices[3] = {krcahIndex, modifiedIndex, descoteauxIndex};
+    for (unsigned int i = 0; i < 3; ++i) {
+        std::cout << "writing sheetness to file " << argv[2 + i] << std::endl;
+        typename SheetnessWriterType::Pointer writer = SheetnessWriterType::New();
+        writer->SetFileName(argv[2 + i]);
+        writer->SetInput(sheetnessFilter->GetOutput(indices[i]));
+        writer->Update();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,13 +1,33 @@
 #ifndef AutomaticSheetnessParameterEstimationImageFilter_h
 #define AutomaticSheetnessParameterEstimationImageFilter_h
 
-#include "FrobeniusNormImageFilter.h"
-#include "itkLabelStatisticsImageFilter.h"
-#include "itkStatisticsImageFilter.h"
+#include "itkImageToImageFilter.h"
+#include "PerformanceTelemetry.h"
+#include "SheetnessParameterStatistics.h"
 
 namespace itk
 {
 
+/** \class AutomaticSheetnessParameterEstimationImageFilter
+ * Sets C to Scale times the maximum Frobenius norm of the eigenvalues, optionally restricted to the voxels of
+ * Label in the label input. The norm is reduced per thread straight from the input buffer, no norm image is
+ * allocated. The input is passed through as the output.
+ *
+ * With UseQuantile on, the maximum is replaced by the Quantile (e.g. 0.99) of the norm, so a few outlier voxels
+ * (implants, streak artefacts) do not set C for the whole volume. Every thread fills a QuantileSketch that are
+ * merged at the end, one pass with bounded memory and no sort. The quantile is within 0.5% of the exact one.
+ * The per-thread statistics, their merge and the sampling below are SheetnessParameterStatistics.
+ *
+ * The statistic can be taken over a subsample of about NumberOfSamples voxels instead of every voxel
+ * (SamplingMode), so the estimation reads a few million voxels per scale instead of sweeping the whole eigenvalue
+ * image. StrideSampling reads every k-th voxel of the buffer, RandomSampling each voxel with probability
+ * NumberOfSamples / N. The random draws depend on Seed and on the image row only, so the result is the same for
+ * every number of threads. The error of the subsample is reported after the update:
+ *  - NumberOfSampledPixels, the number of voxels in the label the statistic is taken over
+ *  - CLowerBound, CUpperBound, a 95% confidence interval of C for a subsampled quantile
+ *  - ExceedanceFraction, the expected fraction of the voxels in the label with a norm above the estimate,
+ *    1 / (n + 1) for the maximum of n samples
+ */
 template <class TInputImage, class TLabelImage>
 class ITK_EXPORT AutomaticSheetnessParameterEstimationImageFilter : public ImageToImageFilter<TInputImage, TInputImage> {
 public:
@@ -29,10 +49,44 @@ public:
   itkSetMacro(Scale,double);
   itkGetMacro(Scale,double);
 
+  itkSetMacro(UseQuantile,bool);
+  itkGetMacro(UseQuantile,bool);
+  itkBooleanMacro(UseQuantile);
+
+  /** Quantile of the norm in [0, 1] used with UseQuantile on. */
+  itkSetClampMacro(Quantile,double,0.0,1.0);
+  itkGetMacro(Quantile,double);
+
+  typedef enum {
+    FullSampling = 0,
+    StrideSampling,
+    RandomSampling
+  } SamplingModeType;
+
+  itkSetMacro(SamplingMode,SamplingModeType);
+  itkGetMacro(SamplingMode,SamplingModeType);
+
+  /** Number of voxels read with StrideSampling or RandomSampling, before the label is applied. */
+  itkSetMacro(NumberOfSamples,SizeValueType);
+  itkGetMacro(NumberOfSamples,SizeValueType);
+
+  itkSetMacro(Seed,unsigned int);
+  itkGetMacro(Seed,unsigned int);
+
+  /** Error report of the last update. */
+  itkGetMacro(NumberOfSampledPixels,SizeValueType);
+  itkGetMacro(CLowerBound,double);
+  itkGetMacro(CUpperBound,double);
+  itkGetMacro(ExceedanceFraction,double);
+
   itkGetMacro(Alpha,double);
   itkGetMacro(Beta,double);
   itkGetMacro(C,double);
 
+  /** Optional per-stage timings of the norm and the maximum computation. */
+  itkSetObjectMacro(Telemetry,PerformanceTelemetry);
+  itkGetObjectMacro(Telemetry,PerformanceTelemetry);
+
   void SetLabelInput(const TLabelImage *input) {
     // Process object is not const-correct so the const casting is required.
     this->SetNthInput( 1, const_cast< TLabelImage * >( input ) );
@@ -55,7 +109,19 @@ public:
 protected:
   AutomaticSheetnessParameterEstimationImageFilter();
   virtual ~AutomaticSheetnessParameterEstimationImageFilter();
-  void GenerateData() ITK_OVERRIDE;
+
+  /** Pass the input through as the output, nothing is allocated. */
+  void AllocateOutputs() ITK_OVERRIDE;
+
+  /** The maximum needs the whole input. */
+  void GenerateInputRequestedRegion() ITK_OVERRIDE;
+  void EnlargeOutputRequestedRegion(DataObject *data) ITK_OVERRIDE;
+
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+  void ThreadedGenerateData(const typename TInputImage::RegionType & outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 private:
   AutomaticSheetnessParameterEstimationImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
@@ -66,15 +132,25 @@ private:
   double m_C;
   double m_Scale;
   TLabelPixelType m_Label;
-
-  // Filter types
-  itkStaticConstMacro(NDimension, unsigned int, TInputImage::ImageDimension);
-  typedef double FrobeniusImagePixelType;
-  typedef Image<FrobeniusImagePixelType, NDimension> TFrobeniusOutputImage;
-
-  typedef FrobeniusNormImageFilter<TInputImage, TFrobeniusOutputImage> FrobeniusNormImageFilterType;
-  typedef LabelStatisticsImageFilter<TFrobeniusOutputImage, TLabelImage> LabelStatisticsImageFilterType;
-  typedef StatisticsImageFilter<TFrobeniusOutputImage> StatisticsImageFilterType;
+  bool m_UseQuantile;
+  double m_Quantile;
+  SamplingModeType m_SamplingMode;
+  SizeValueType m_NumberOfSamples;
+  unsigned int m_Seed;
+  PerformanceTelemetry::Pointer m_Telemetry;
+
+  // Error report
+  SizeValueType m_NumberOfSampledPixels;
+  double m_CLowerBound;
+  double m_CUpperBound;
+  double m_ExceedanceFraction;
+
+  // Input buffer of the update, the voxels are addressed by their offset
+  const typename TInputImage::PixelType *m_InputBuffer;
+  const TLabelPixelType *m_LabelBuffer;
+
+  // Per-thread maximum, count and sketch of the squared norm
+  SheetnessParameterStatistics m_Statistics;
 }; // class AutomaticSheetnessParameterEstimationImageFilter
 
 } // namespace itk
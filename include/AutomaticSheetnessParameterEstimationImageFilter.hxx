@@ -1,12 +1,18 @@
 #ifndef _AutomaticSheetnessParameterEstimationImageFilter_hxx_
 #define _AutomaticSheetnessParameterEstimationImageFilter_hxx_
 
+#include "itkImageLinearConstIteratorWithIndex.h"
+
 namespace itk {
     template <class TInputImage, class TLabelImage>
     AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
     ::AutomaticSheetnessParameterEstimationImageFilter()
         : m_Alpha(0.5f), m_Beta(0.5f), m_C(0.5f),
-        m_Label(1.0f), m_Scale(0.1f)
+        m_Label(1.0f), m_Scale(0.1f),
+        m_UseQuantile(false), m_Quantile(0.99),
+        m_SamplingMode(FullSampling), m_NumberOfSamples(2000000), m_Seed(0),
+        m_NumberOfSampledPixels(0), m_CLowerBound(0), m_CUpperBound(0), m_ExceedanceFraction(0),
+        m_InputBuffer(ITK_NULLPTR), m_LabelBuffer(ITK_NULLPTR)
     {
         this->SetNumberOfRequiredInputs(1);
     }
@@ -18,31 +24,112 @@ namespace itk {
 
     template <class TInputImage, class TLabelImage>
     void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
-    ::GenerateData() {
-        // Compute Frobenius norm
-        typename FrobeniusNormImageFilterType::Pointer frobeniusFilter = FrobeniusNormImageFilterType::New();
-        frobeniusFilter->SetInput(this->GetInput());
-
-        // Compute max
-        if (this->GetLabelInput() == ITK_NULLPTR) { // Not verified yet...
-            typename StatisticsImageFilterType::Pointer statisticsFilter = StatisticsImageFilterType::New();
-            statisticsFilter->SetInput(frobeniusFilter->GetOutput());
-            statisticsFilter->Update();
-            
-            // Set C
-            m_C = static_cast<double>(this->GetScale() * statisticsFilter->GetMaximum());
-        } else {
-            typename LabelStatisticsImageFilterType::Pointer statisticsFilter = LabelStatisticsImageFilterType::New();
-            statisticsFilter->SetInput(frobeniusFilter->GetOutput());
-            statisticsFilter->SetLabelInput(this->GetLabelInput());
-            statisticsFilter->Update();
-
-            // Set C
-            m_C = static_cast<double>(this->GetScale() * statisticsFilter->GetMaximum(this->GetLabel()));
+    ::AllocateOutputs() {
+        // Pass the input through as the output
+        TInputImage *image = const_cast<TInputImage *>(this->GetInput());
+        this->GraftOutput(image);
+    }
+
+    template <class TInputImage, class TLabelImage>
+    void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
+    ::GenerateInputRequestedRegion() {
+        Superclass::GenerateInputRequestedRegion();
+
+        TInputImage *input = const_cast<TInputImage *>(this->GetInput());
+        if (input) {
+            input->SetRequestedRegionToLargestPossibleRegion();
+        }
+        TLabelImage *label = const_cast<TLabelImage *>(this->GetLabelInput());
+        if (label) {
+            label->SetRequestedRegionToLargestPossibleRegion();
+        }
+    }
+
+    template <class TInputImage, class TLabelImage>
+    void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
+    ::EnlargeOutputRequestedRegion(DataObject *data) {
+        Superclass::EnlargeOutputRequestedRegion(data);
+        data->SetRequestedRegionToLargestPossibleRegion();
+    }
+
+    template <class TInputImage, class TLabelImage>
+    void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
+    ::BeforeThreadedGenerateData() {
+        if (m_Telemetry) {
+            m_Telemetry->StartStage("maximum norm");
+        }
+
+        // The voxels are addressed by their offset in the buffers, which have to match
+        const TInputImage *input = this->GetInput();
+        m_InputBuffer = input->GetBufferPointer();
+        m_LabelBuffer = ITK_NULLPTR;
+        if (this->GetLabelInput() != ITK_NULLPTR) {
+            if (this->GetLabelInput()->GetBufferedRegion() != input->GetBufferedRegion()) {
+                itkExceptionMacro(<< "The label image has to cover the same region as the input");
+            }
+            m_LabelBuffer = this->GetLabelInput()->GetBufferPointer();
         }
 
-        // Set output
-        this->GetOutput()->Graft(this->GetInput());
+        m_Statistics.Initialize(this->GetNumberOfThreads(), m_UseQuantile,
+                                input->GetBufferedRegion().GetNumberOfPixels(), input->GetBufferedRegion().GetSize(0),
+                                m_SamplingMode == FullSampling ? 0 : m_NumberOfSamples,
+                                m_SamplingMode == RandomSampling, m_Seed);
+    }
+
+    template <class TInputImage, class TLabelImage>
+    void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
+    ::ThreadedGenerateData(const typename TInputImage::RegionType & outputRegionForThread, ThreadIdType threadId) {
+        // Compare squared norms, the square root is taken once on the merged result
+        SheetnessParameterStatistics::ThreadStatistics statistics = m_Statistics.GetThreadStatistics(threadId);
+
+        // Rows of the region are contiguous in the buffer
+        const TInputImage *input = this->GetInput();
+        const IndexValueType rowStart = input->GetBufferedRegion().GetIndex(0);
+        ImageLinearConstIteratorWithIndex<TInputImage> it(input, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const OffsetValueType begin = input->ComputeOffset(it.GetIndex());
+            const OffsetValueType end = begin + outputRegionForThread.GetSize(0);
+            m_Statistics.InsertSamples(begin, end, begin - (it.GetIndex()[0] - rowStart), m_InputBuffer, m_LabelBuffer,
+                                       m_Label, statistics);
+        }
+        m_Statistics.AddThreadStatistics(threadId, statistics);
+    }
+
+    template <class TInputImage, class TLabelImage>
+    void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
+    ::AfterThreadedGenerateData() {
+        // Merge the per-thread statistics and set C
+        m_Statistics.Merge(this->GetScale(), m_Quantile);
+        m_C = m_Statistics.GetC();
+        m_CLowerBound = m_Statistics.GetCLowerBound();
+        m_CUpperBound = m_Statistics.GetCUpperBound();
+        m_ExceedanceFraction = m_Statistics.GetExceedanceFraction();
+        m_NumberOfSampledPixels = m_Statistics.GetNumberOfSampledPixels();
+        if (this->GetLabelInput() != ITK_NULLPTR && m_NumberOfSampledPixels == 0) {
+            itkWarningMacro(<< "No voxel with label " << static_cast<double>(m_Label) << ", C is set to 0");
+        }
+
+        if (m_Telemetry) {
+            m_Telemetry->StopStage("maximum norm", m_Statistics.GetNumberOfVisitedPixels(), 0,
+                                  m_Statistics.GetNumberOfThreads());
+        }
+    }
+
+    template <class TInputImage, class TLabelImage>
+    void AutomaticSheetnessParameterEstimationImageFilter<TInputImage, TLabelImage>
+    ::PrintSelf(std::ostream & os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Scale: " << m_Scale << std::endl;
+        os << indent << "Label: " << static_cast<double>(m_Label) << std::endl;
+        os << indent << "UseQuantile: " << m_UseQuantile << std::endl;
+        os << indent << "Quantile: " << m_Quantile << std::endl;
+        os << indent << "SamplingMode: " << m_SamplingMode << std::endl;
+        os << indent << "NumberOfSamples: " << m_NumberOfSamples << std::endl;
+        os << indent << "Seed: " << m_Seed << std::endl;
+        os << indent << "C: " << m_C << " [" << m_CLowerBound << ", " << m_CUpperBound << "]" << std::endl;
+        os << indent << "NumberOfSampledPixels: " << m_NumberOfSampledPixels << std::endl;
+        os << indent << "ExceedanceFraction: " << m_ExceedanceFraction << std::endl;
     }
 }
 
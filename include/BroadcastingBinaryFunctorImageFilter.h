@@ -1,21 +1,23 @@
 /**
 * TODO:
-* - Input2 is 3d with the relevant axis dimension = 1. change to 2d?
-* - dimension along which to broadcast is set statically
+* - Input2 has the dimension of input1 with size 1 along the broadcast axes. change to a lower dimension?
 */
 
 #ifndef __BroadcastingBinaryFunctorImageFilter_h_
 #define __BroadcastingBinaryFunctorImageFilter_h_
 
 #include "itkImageToImageFilter.h"
+#include "itkFixedArray.h"
+#include "DynamicThreadedImageFilter.h"
 
 namespace itk {
     template<typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor>
-    class BroadcastingBinaryFunctorImageFilter : public ImageToImageFilter<TInputImage1, TOutputImage> {
+    class BroadcastingBinaryFunctorImageFilter
+            : public DynamicThreadedImageFilter<ImageToImageFilter<TInputImage1, TOutputImage> > {
     public:
         /** Standard class typedefs. */
         typedef BroadcastingBinaryFunctorImageFilter Self;
-        typedef ImageToImageFilter<TInputImage1, TOutputImage> Superclass;
+        typedef DynamicThreadedImageFilter<ImageToImageFilter<TInputImage1, TOutputImage> > Superclass;
         typedef SmartPointer<Self> Pointer;
         typedef SmartPointer<const Self> ConstPointer;
 
@@ -46,6 +48,11 @@ namespace itk {
         typedef typename OutputImageType::RegionType OutputImageRegionType;
         typedef typename OutputImageType::PixelType OutputImagePixelType;
 
+        itkStaticConstMacro(ImageDimension, unsigned int, TInputImage1::ImageDimension);
+
+        // true for every axis along which the value of input2 is repeated, input2 has size 1 along these axes
+        typedef FixedArray<bool, TInputImage1::ImageDimension> BroadcastAxesType;
+
         /** Methods */
         virtual void SetInput1(const TInputImage1 *image1);
 
@@ -67,6 +74,16 @@ namespace itk {
             }
         }
 
+        // broadcast along the given axes instead of the axes where input2 has size 1 and input1 has not
+        void SetBroadcastAxes(const BroadcastAxesType &axes) {
+            m_BroadcastAxes = axes;
+            m_InferBroadcastAxes = false;
+            this->Modified();
+        }
+
+        // the axes that were set, or the inferred axes after the output information was generated
+        itkGetConstReferenceMacro(BroadcastAxes, BroadcastAxesType);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
 // TODO:
 #endif
@@ -77,10 +94,12 @@ namespace itk {
         ~BroadcastingBinaryFunctorImageFilter() {
         }
 
-        // work distribution is handled by the superclass
+        // called once per chunk by the superclass, see DynamicThreadedImageFilter. Every line along axis 0 is a loop over raw buffer pointers,
+        // input2 is read with a stride of 1, or of 0 when axis 0 is a broadcast axis.
         void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread,
                 ThreadIdType threadId);
 
+        // the input sizes have to match on all axes but the broadcast axes, where input2 has size 1
         void VerifyInputInformation();
         void GenerateInputRequestedRegion();
 
@@ -91,6 +110,8 @@ namespace itk {
         void operator=(const Self &);                       //purposely not implemented
 
         FunctorType m_Functor;
+        BroadcastAxesType m_BroadcastAxes;
+        bool m_InferBroadcastAxes;
     };
 } //namespace ITK
 
@@ -1,11 +1,13 @@
-#include "itkImageSliceConstIteratorWithIndex.h"
-#include "itkImageSliceIteratorWithIndex.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
 
 namespace itk {
     template<typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor>
     BroadcastingBinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunctor>
-    ::BroadcastingBinaryFunctorImageFilter() {
+    ::BroadcastingBinaryFunctorImageFilter()
+            : m_InferBroadcastAxes(true) {
         this->SetNumberOfRequiredInputs(2);
+        m_BroadcastAxes.Fill(false);
     }
 
     template<typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor>
@@ -44,35 +46,44 @@ namespace itk {
 
         // processing
         const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+        ProgressReporter progress(this, threadId, numberOfLinesToProcess);
 
-        ImageSliceConstIteratorWithIndex<TInputImage1> inputIt1(inputPtr1, outputRegionForThread);
-        ImageRegionConstIteratorWithIndex<TInputImage2> inputIt2(inputPtr2, inputPtr2->GetLargestPossibleRegion());
-        ImageRegionIterator<TOutputImage> outputIt(outputPtr, outputRegionForThread);
-
-        // TODO: replace the static definition of the 'flat' plane with something that works in every case
-        inputIt1.SetFirstDirection(0);
-        inputIt1.SetSecondDirection(1);
-        inputIt1.GoToBegin();
+        // input2 index of a line: the start of input2 along the broadcast axes, shifted by the offset between the
+        // two largest possible regions along the others
+        const typename TInputImage1::IndexType start1 = inputPtr1->GetLargestPossibleRegion().GetIndex();
+        const typename TInputImage2::IndexType start2 = inputPtr2->GetLargestPossibleRegion().GetIndex();
+
+        const Input1ImagePixelType *buffer1 = inputPtr1->GetBufferPointer();
+        const Input2ImagePixelType *buffer2 = inputPtr2->GetBufferPointer();
+        OutputImagePixelType *bufferOut = outputPtr->GetBufferPointer();
+
+        FunctorType functor = m_Functor;
+        ImageLinearConstIteratorWithIndex<TOutputImage> it(outputPtr, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const typename TOutputImage::IndexType index = it.GetIndex();
+            typename TInputImage2::IndexType index2;
+            for (unsigned int d = 0; d < ImageDimension; ++d) {
+                index2[d] = m_BroadcastAxes[d] ? start2[d] : index[d] - start1[d] + start2[d];
+            }
 
-        outputIt.GoToBegin();
-        typename TInputImage1::IndexType idxIt1 = inputIt1.GetIndex();
-        idxIt1[2] = 0; // TODO: replace static dimension
-        inputIt2.SetIndex(idxIt1);
+            const Input1ImagePixelType *line1 = buffer1 + inputPtr1->ComputeOffset(index);
+            const Input2ImagePixelType *line2 = buffer2 + inputPtr2->ComputeOffset(index2);
+            OutputImagePixelType *lineOut = bufferOut + outputPtr->ComputeOffset(index);
 
-        ProgressReporter progress(this, threadId, numberOfLinesToProcess);
-
-        while (!inputIt1.IsAtEnd() && !inputIt2.IsAtEnd()) {
-            while (!inputIt1.IsAtEndOfSlice()) {
-                while (!inputIt1.IsAtEndOfLine()) {
-                    outputIt.Set(m_Functor(inputIt1.Get(), inputIt2.Get()));
-                    ++inputIt1;
-                    ++outputIt;
+            if (m_BroadcastAxes[0]) {
+                // one value of input2 for the whole line
+                const Input2ImagePixelType value2 = *line2;
+                for (SizeValueType i = 0; i < size0; ++i) {
+                    lineOut[i] = functor(line1[i], value2);
+                }
+            } else {
+                // contiguous in all three buffers
+                for (SizeValueType i = 0; i < size0; ++i) {
+                    lineOut[i] = functor(line1[i], line2[i]);
                 }
-                inputIt1.NextLine();
-                progress.CompletedPixel();
             }
-            inputIt1.NextSlice();
-            inputIt2.SetIndex(idxIt1);
+            progress.CompletedPixel();
         }
     }
 
@@ -81,7 +92,24 @@ namespace itk {
     BroadcastingBinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunctor>
     ::VerifyInputInformation() {
         // itkImageToImageFilter.hxx implements a check for identical physical space which obviously
-        // fails with this filter, so we overwrite it
+        // fails with this filter, so we overwrite it and only check the sizes
+        const TInputImage1 *inputPtr1 = dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
+        const TInputImage2 *inputPtr2 = dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
+        if (!inputPtr1 || !inputPtr2) {
+            return;
+        }
+
+        const typename TInputImage1::SizeType size1 = inputPtr1->GetLargestPossibleRegion().GetSize();
+        const typename TInputImage2::SizeType size2 = inputPtr2->GetLargestPossibleRegion().GetSize();
+        for (unsigned int d = 0; d < ImageDimension; ++d) {
+            if (m_InferBroadcastAxes) {
+                m_BroadcastAxes[d] = size2[d] == 1 && size1[d] != 1;
+            }
+            if (m_BroadcastAxes[d] ? size2[d] != 1 : size2[d] != size1[d]) {
+                itkExceptionMacro(<< "Input2 of size " << size2 << " can not be broadcast to input1 of size " << size1
+                                  << " along the axes " << m_BroadcastAxes);
+            }
+        }
     }
 
     template<typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor>
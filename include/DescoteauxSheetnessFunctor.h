@@ -0,0 +1,108 @@
+#ifndef __DescoteauxSheetnessFunctor_h_
+#define __DescoteauxSheetnessFunctor_h_
+
+#include "vnl/vnl_math.h"
+#include "FastExp.h"
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+    namespace Functor {
+        /*
+         * Sheetness measure of Descoteaux et al., the functor of itk::DescoteauxSheetnessImageFilter in the
+         * LesionSizingToolkit module, without requiring that module. Sheets of the other polarity are 0.
+         *
+         *   Rs = l2 / l3, Rb = |2 l3 - l2 - l1| / l3, Rn = sqrt(l1^2 + l2^2 + l3^2)
+         *   sheetness = exp(-Rs^2 / 2 alpha^2) (1 - exp(-Rb^2 / 2 gamma^2)) (1 - exp(-Rn^2 / 2 c^2))
+         */
+        template<class TInputPixel, class TOutputPixel>
+        class DescoteauxSheetness {
+        public:
+            DescoteauxSheetness() {
+                m_Alpha = 0.5;
+                m_Gamma = 0.5;
+                m_C = 1.0;
+                m_DetectBrightSheets = true;
+                m_UseFastExp = false;
+            }
+
+            inline TOutputPixel operator()(const TInputPixel &A) {
+                double sheetness = 0.0;
+                double a1 = static_cast<double>( A[0] );
+                double a2 = static_cast<double>( A[1] );
+                double a3 = static_cast<double>( A[2] );
+                double l1 = vnl_math_abs(a1);
+                double l2 = vnl_math_abs(a2);
+                double l3 = vnl_math_abs(a3);
+
+                // Sort the values by their absolute value, l1 <= l2 <= l3
+                if (l2 > l3) {
+                    std::swap(l2, l3);
+                    std::swap(a2, a3);
+                }
+                if (l1 > l2) {
+                    std::swap(l1, l2);
+                    std::swap(a1, a2);
+                }
+                if (l2 > l3) {
+                    std::swap(l2, l3);
+                    std::swap(a2, a3);
+                }
+
+                // only sheets of the requested polarity
+                if (m_DetectBrightSheets ? a3 > 0.0 : a3 < 0.0) {
+                    return static_cast<TOutputPixel>( sheetness );
+                }
+
+                // Avoid divisions by zero (or close to zero)
+                if (l3 < vnl_math::eps) {
+                    return static_cast<TOutputPixel>( sheetness );
+                }
+
+                const double Rs = l2 / l3;
+                const double Rb = vnl_math_abs(l3 + l3 - l2 - l1) / l3;
+                const double Rn = std::sqrt(l3 * l3 + l2 * l2 + l1 * l1);
+
+                sheetness = exponential(-(Rs * Rs) / (2.0 * m_Alpha * m_Alpha));
+                sheetness *= (1.0 - exponential(-(Rb * Rb) / (2.0 * m_Gamma * m_Gamma)));
+                sheetness *= (1.0 - exponential(-(Rn * Rn) / (2.0 * m_C * m_C)));
+
+                return static_cast<TOutputPixel>( sheetness );
+            }
+
+            void SetAlpha(double value) {
+                this->m_Alpha = value;
+            }
+
+            void SetGamma(double value) {
+                this->m_Gamma = value;
+            }
+
+            void SetC(double value) {
+                this->m_C = value;
+            }
+
+            void SetDetectBrightSheets(bool value) {
+                this->m_DetectBrightSheets = value;
+            }
+
+            // evaluate the exponentials with FastExp, relative error below FastExpMaximumRelativeError
+            void SetUseFastExp(bool value) {
+                this->m_UseFastExp = value;
+            }
+
+        private:
+            inline double exponential(double x) const {
+                return m_UseFastExp ? FastExp(x) : std::exp(x);
+            }
+
+            double m_Alpha;
+            double m_Gamma;
+            double m_C;
+            bool m_DetectBrightSheets;
+            bool m_UseFastExp;
+        };
+    }
+}
+
+#endif // __DescoteauxSheetnessFunctor_h_
@@ -0,0 +1,65 @@
+#ifndef __DiscreteHessianImageFilter_h_
+#define __DiscreteHessianImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkNumericTraits.h"
+
+namespace itk {
+    /*
+     * Hessian of an image by central differences, without any smoothing. Meant for an image that is already
+     * smoothed to the scale of interest, e.g. one level of a Gaussian scale space:
+     *
+     *   H_dd = (f(x + e_d) - 2 f(x) + f(x - e_d)) / h_d^2
+     *   H_de = (f(x + e_d + e_e) - f(x + e_d - e_e) - f(x - e_d + e_e) + f(x - e_d - e_e)) / (4 h_d h_e)
+     *
+     * with the image spacing h. One pass over a 3^D neighborhood instead of the directional recursive passes of
+     * HessianRecursiveGaussianImageFilter. The image is extended by zero flux at its boundary.
+     */
+    template<typename TInputImage, typename TOutputImage = Image<SymmetricSecondRankTensor<
+            typename NumericTraits<typename TInputImage::PixelType>::RealType, TInputImage::ImageDimension>,
+            TInputImage::ImageDimension> >
+    class ITK_EXPORT DiscreteHessianImageFilter : public ImageToImageFilter<TInputImage, TOutputImage> {
+    public:
+        typedef DiscreteHessianImageFilter Self;
+        typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(DiscreteHessianImageFilter, ImageToImageFilter);
+        itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+        typedef TInputImage InputImageType;
+        typedef TOutputImage OutputImageType;
+        typedef typename OutputImageType::PixelType OutputPixelType;
+        typedef typename OutputImageType::RegionType OutputImageRegionType;
+        typedef typename NumericTraits<OutputPixelType>::ValueType OutputComponentType;
+
+    protected:
+        DiscreteHessianImageFilter() {
+            this->SetNumberOfRequiredInputs(1);
+        }
+
+        virtual ~DiscreteHessianImageFilter() {
+        }
+
+        // the differences need one voxel around the output requested region
+        void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+        void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+
+    private:
+        DiscreteHessianImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "DiscreteHessianImageFilter.hxx"
+
+#endif
+
+#endif //__DiscreteHessianImageFilter_h_
@@ -0,0 +1,94 @@
+#ifndef __DiscreteHessianImageFilter_hxx_
+#define __DiscreteHessianImageFilter_hxx_
+
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkNeighborhoodAlgorithm.h"
+#include "itkProgressReporter.h"
+
+namespace itk {
+    template<typename TInputImage, typename TOutputImage>
+    void DiscreteHessianImageFilter<TInputImage, TOutputImage>
+    ::GenerateInputRequestedRegion() {
+        Superclass::GenerateInputRequestedRegion();
+
+        typename InputImageType::Pointer input = const_cast<InputImageType *>(this->GetInput());
+        if (!input) {
+            return;
+        }
+
+        typename InputImageType::RegionType requested = input->GetRequestedRegion();
+        requested.PadByRadius(1);
+        requested.Crop(input->GetLargestPossibleRegion());
+        input->SetRequestedRegion(requested);
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void DiscreteHessianImageFilter<TInputImage, TOutputImage>
+    ::ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) {
+        typedef ConstNeighborhoodIterator<InputImageType> NeighborhoodIteratorType;
+        typedef typename NeighborhoodIteratorType::OffsetType OffsetType;
+        typedef NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<InputImageType> FacesCalculatorType;
+
+        const InputImageType *input = this->GetInput();
+        OutputImageType *output = this->GetOutput();
+
+        const typename InputImageType::SpacingType spacing = input->GetSpacing();
+        typename NeighborhoodIteratorType::RadiusType radius;
+        radius.Fill(1);
+
+        ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+        // the interior face needs no boundary condition
+        FacesCalculatorType facesCalculator;
+        typename FacesCalculatorType::FaceListType faces = facesCalculator(input, outputRegionForThread, radius);
+        for (typename FacesCalculatorType::FaceListType::iterator face = faces.begin(); face != faces.end(); ++face) {
+            NeighborhoodIteratorType it(radius, input, *face);
+            ImageRegionIterator<OutputImageType> ot(output, *face);
+
+            // neighborhood positions of the differences
+            const unsigned int center = it.Size() / 2;
+            unsigned int forward[ImageDimension];
+            unsigned int backward[ImageDimension];
+            unsigned int mixed[ImageDimension][ImageDimension][4];
+            const int sign[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+            for (unsigned int d = 0; d < ImageDimension; ++d) {
+                OffsetType offset;
+                offset.Fill(0);
+                offset[d] = 1;
+                forward[d] = it.GetNeighborhoodIndex(offset);
+                offset[d] = -1;
+                backward[d] = it.GetNeighborhoodIndex(offset);
+                for (unsigned int e = d + 1; e < ImageDimension; ++e) {
+                    for (unsigned int s = 0; s < 4; ++s) {
+                        offset.Fill(0);
+                        offset[d] = sign[s][0];
+                        offset[e] = sign[s][1];
+                        mixed[d][e][s] = it.GetNeighborhoodIndex(offset);
+                    }
+                }
+            }
+
+            for (it.GoToBegin(), ot.GoToBegin(); !it.IsAtEnd(); ++it, ++ot) {
+                OutputPixelType hessian;
+                const double value = it.GetPixel(center);
+                for (unsigned int d = 0; d < ImageDimension; ++d) {
+                    hessian(d, d) = static_cast<OutputComponentType>(
+                            (static_cast<double>(it.GetPixel(forward[d])) - 2 * value
+                             + static_cast<double>(it.GetPixel(backward[d]))) / (spacing[d] * spacing[d]));
+                    for (unsigned int e = d + 1; e < ImageDimension; ++e) {
+                        hessian(d, e) = static_cast<OutputComponentType>(
+                                (static_cast<double>(it.GetPixel(mixed[d][e][0]))
+                                 - static_cast<double>(it.GetPixel(mixed[d][e][1]))
+                                 - static_cast<double>(it.GetPixel(mixed[d][e][2]))
+                                 + static_cast<double>(it.GetPixel(mixed[d][e][3]))) / (4 * spacing[d] * spacing[e]));
+                    }
+                }
+                ot.Set(hessian);
+                progress.CompletedPixel();
+            }
+        }
+    }
+}
+
+#endif // __DiscreteHessianImageFilter_hxx_
@@ -0,0 +1,92 @@
+#ifndef __DualPolarityKrcahSheetnessImageFilter_h_
+#define __DualPolarityKrcahSheetnessImageFilter_h_
+
+#include "KrcahSheetnessImageFilter.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace itk {
+    /*
+     * KrcahSheetnessImageFilter with the bright and the dark sheetness as two outputs.
+     *
+     * The Krcah measure detects bright sheets, -sgn(a3) times the product of the exponential terms. The dark sheetness
+     * is +sgn(a3) times the same product, so both outputs come from one evaluation of the eigenvalues and the exps:
+     * output 0 equals KrcahSheetnessImageFilter and output 1 is its negation, written in the same line loop.
+     */
+    template<typename TInputImage, typename TConstant, typename TOutputImage>
+    class DualPolarityKrcahSheetnessImageFilter : public KrcahSheetnessImageFilter<TInputImage, TConstant, TOutputImage> {
+    public:
+        // itk requirements
+        typedef DualPolarityKrcahSheetnessImageFilter Self;
+        typedef KrcahSheetnessImageFilter<TInputImage, TConstant, TOutputImage> Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self); // create the smart pointers and register with ITKs object factory
+        itkTypeMacro(DualPolarityKrcahSheetnessImageFilter, KrcahSheetnessImageFilter); // type information for runtime evaluation
+
+        typedef typename Superclass::Input1ImageType Input1ImageType;
+        typedef typename Superclass::Input2ImageType Input2ImageType;
+        typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+        // sheetness of bright sheets on a dark background, output 0
+        TOutputImage *GetBrightSheetnessOutput() {
+            return this->GetOutput(0);
+        }
+
+        // sheetness of dark sheets on a bright background, output 1
+        TOutputImage *GetDarkSheetnessOutput() {
+            return this->GetOutput(1);
+        }
+
+    protected:
+        DualPolarityKrcahSheetnessImageFilter() {
+            this->SetNumberOfRequiredOutputs(2);
+            this->SetNthOutput(1, this->MakeOutput(1));
+            this->InPlaceOff();
+        };
+
+        virtual ~DualPolarityKrcahSheetnessImageFilter() {
+        };
+
+        // bright sheetness of a line with the batch functor, the dark one by negation of that line
+        void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE {
+            const SizeValueType length = outputRegionForThread.GetSize(0);
+            if (length == 0) {
+                return;
+            }
+
+            const Input1ImageType *input = dynamic_cast<const Input1ImageType *>(ProcessObject::GetInput(0));
+            const Input2ImageType *trace = dynamic_cast<const Input2ImageType *>(ProcessObject::GetInput(1));
+            TOutputImage *bright = this->GetOutput(0);
+            TOutputImage *dark = this->GetOutput(1);
+
+            // a trace set with SetConstant2 is broadcast with a stride of 0
+            const TConstant constant = trace ? TConstant() : this->GetConstant2();
+            const std::ptrdiff_t traceStride = trace ? 1 : 0;
+
+            const typename Superclass::FunctorType &functor = this->GetFunctor();
+            ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / length);
+
+            ImageLinearConstIteratorWithIndex<TOutputImage> it(bright, outputRegionForThread);
+            it.SetDirection(0);
+            for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+                const typename TOutputImage::IndexType index = it.GetIndex();
+                const TConstant *t = trace ? trace->GetBufferPointer() + trace->ComputeOffset(index) : &constant;
+                typename TOutputImage::PixelType *brightLine = bright->GetBufferPointer() + bright->ComputeOffset(index);
+                typename TOutputImage::PixelType *darkLine = dark->GetBufferPointer() + dark->ComputeOffset(index);
+                functor.Evaluate(input->GetBufferPointer() + input->ComputeOffset(index), t, traceStride, brightLine, length);
+                for (SizeValueType i = 0; i < length; ++i) {
+                    darkLine[i] = -brightLine[i];
+                }
+                progress.CompletedPixel();
+            }
+        }
+
+    private:
+        DualPolarityKrcahSheetnessImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &);   //purposely not implemented
+    };
+}
+
+#endif //__DualPolarityKrcahSheetnessImageFilter_h_
@@ -0,0 +1,95 @@
+#ifndef DualPolarityModifiedSheetnessImageFilter_h
+#define DualPolarityModifiedSheetnessImageFilter_h
+
+#include "ModifiedSheetnessImageFilter.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace itk {
+
+/** \class DualPolarityModifiedSheetnessImageFilter
+ * \brief ModifiedSheetnessImageFilter with the bright and the dark sheetness as two outputs.
+ *
+ * The polarity only enters the measure as the sign in front of the product of the exponential terms, so the dark
+ * sheetness is the negated bright sheetness. Both outputs come from one eigenvalue evaluation, output 0 equals
+ * ModifiedSheetnessImageFilter with DetectBrightSheetsOn() and output 1 equals it with DetectDarkSheetsOn().
+ * Both are written in the same line loop. DetectBrightSheetsOn() and DetectDarkSheetsOn() of the superclass set the
+ * polarity of the functor, which only decides which output gets the functor value and which its negation: output 0
+ * is always the bright and output 1 always the dark sheetness.
+ */
+template <class TInputImage, class TOutputImage>
+class ITK_EXPORT DualPolarityModifiedSheetnessImageFilter :
+    public ModifiedSheetnessImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef DualPolarityModifiedSheetnessImageFilter              Self;
+  typedef ModifiedSheetnessImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>                                    Pointer;
+  typedef SmartPointer<const Self>                              ConstPointer;
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(DualPolarityModifiedSheetnessImageFilter, ModifiedSheetnessImageFilter);
+
+  /** Sheetness of bright sheets on a dark background, output 0. */
+  TOutputImage * GetBrightSheetnessOutput() {
+    return this->GetOutput(0);
+  }
+
+  /** Sheetness of dark sheets on a bright background, output 1. */
+  TOutputImage * GetDarkSheetnessOutput() {
+    return this->GetOutput(1);
+  }
+
+protected:
+  DualPolarityModifiedSheetnessImageFilter() {
+    this->SetNumberOfRequiredOutputs(2);
+    this->SetNthOutput(1, this->MakeOutput(1));
+    this->InPlaceOff();
+  }
+  virtual ~DualPolarityModifiedSheetnessImageFilter() {}
+
+  /** Functor value into one output and its negation into the other, line by line. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE {
+    const SizeValueType length = outputRegionForThread.GetSize(0);
+    if (length == 0) {
+      return;
+    }
+
+    const TInputImage *input = this->GetInput();
+    TOutputImage *bright = this->GetOutput(0);
+    TOutputImage *dark = this->GetOutput(1);
+
+    typename Superclass::FunctorType functor = this->GetFunctor();
+    const bool functorIsBright = functor.IsDetectBrightSheetsOn();
+    ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / length);
+
+    ImageLinearConstIteratorWithIndex<TOutputImage> it(bright, outputRegionForThread);
+    it.SetDirection(0);
+    for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+      const typename TOutputImage::IndexType index = it.GetIndex();
+      const typename TInputImage::PixelType *line = input->GetBufferPointer() + input->ComputeOffset(index);
+      typename TOutputImage::PixelType *brightLine = bright->GetBufferPointer() + bright->ComputeOffset(index);
+      typename TOutputImage::PixelType *darkLine = dark->GetBufferPointer() + dark->ComputeOffset(index);
+      for (SizeValueType i = 0; i < length; ++i) {
+        const typename TOutputImage::PixelType value = functor(line[i]);
+        brightLine[i] = functorIsBright ? value : -value;
+        darkLine[i] = functorIsBright ? -value : value;
+      }
+      progress.CompletedPixel();
+    }
+  }
+
+private:
+  DualPolarityModifiedSheetnessImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+}; // class DualPolarityModifiedSheetnessImageFilter
+
+} // end namespace itk
+
+#endif /* DualPolarityModifiedSheetnessImageFilter_h */
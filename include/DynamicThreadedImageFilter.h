@@ -0,0 +1,80 @@
+#ifndef __DynamicThreadedImageFilter_h_
+#define __DynamicThreadedImageFilter_h_
+
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+
+#include <atomic>
+
+namespace itk {
+    /*
+     * Dynamic scheduling for a filter that implements ThreadedGenerateData. The static split of ImageSource gives
+     * every thread one slab of the output, with early-outs or masks the work per voxel differs by orders of
+     * magnitude (air against bone) and the threads with the cheap slabs wait for the others. Here the output
+     * requested region is cut into NumberOfChunksPerThread * NumberOfThreads chunks along the slowest dimensions
+     * and the threads take the next chunk from a shared counter until none is left.
+     *
+     *   template<...> class SomeFilter : public DynamicThreadedImageFilter<UnaryFunctorImageFilter<...> >
+     *
+     * ThreadedGenerateData is called once per chunk, so it must not assume a single call per thread: per thread
+     * results have to be accumulated. A NumberOfChunksPerThread of 1 gives the static split.
+     *
+     * The progress is the fraction of completed chunks, counted by all threads and reported by the first one. A
+     * ProgressReporter only reports for thread 0, so to keep the reporters in the ThreadedGenerateData of the
+     * superclasses from restarting at 0 for every chunk, the chunks are processed with the thread ids 1 to
+     * NumberOfThreads: per thread results need GetNumberOfThreads() + 1 slots.
+     */
+    template<typename TSuperclass>
+    class ITK_EXPORT DynamicThreadedImageFilter : public TSuperclass {
+    public:
+        typedef DynamicThreadedImageFilter Self;
+        typedef TSuperclass Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkTypeMacro(DynamicThreadedImageFilter, ImageToImageFilter);
+
+        typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+        itkSetClampMacro(NumberOfChunksPerThread, unsigned int, 1, NumericTraits<unsigned int>::max());
+        itkGetConstMacro(NumberOfChunksPerThread, unsigned int);
+
+        // chunks of the last update, fewer than requested if the region is small
+        itkGetConstMacro(NumberOfChunks, unsigned int);
+
+    protected:
+        DynamicThreadedImageFilter();
+
+        virtual ~DynamicThreadedImageFilter() {
+        }
+
+        void GenerateData() ITK_OVERRIDE;
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        DynamicThreadedImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        static ITK_THREAD_RETURN_TYPE chunkThreaderCallback(void *arg);
+
+        // take chunks from the shared counter until none is left, workerId is the id of the threader
+        void processChunks(ThreadIdType workerId);
+
+        unsigned int m_NumberOfChunksPerThread;
+        unsigned int m_NumberOfChunks;
+        OutputImageRegionType m_ChunkedRegion;
+        ImageRegionSplitterSlowDimension::Pointer m_Splitter;
+        std::atomic<unsigned int> m_NextChunk;
+        std::atomic<unsigned int> m_CompletedChunks;
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "DynamicThreadedImageFilter.hxx"
+
+#endif
+
+#endif //__DynamicThreadedImageFilter_h_
@@ -0,0 +1,65 @@
+#ifndef __DynamicThreadedImageFilter_hxx_
+#define __DynamicThreadedImageFilter_hxx_
+
+namespace itk {
+    template<typename TSuperclass>
+    DynamicThreadedImageFilter<TSuperclass>
+    ::DynamicThreadedImageFilter()
+            : m_NumberOfChunksPerThread(16), m_NumberOfChunks(0), m_Splitter(ImageRegionSplitterSlowDimension::New())
+            , m_NextChunk(0), m_CompletedChunks(0) {
+    }
+
+    template<typename TSuperclass>
+    void DynamicThreadedImageFilter<TSuperclass>
+    ::GenerateData() {
+        this->AllocateOutputs();
+        this->BeforeThreadedGenerateData();
+
+        m_ChunkedRegion = this->GetOutput()->GetRequestedRegion();
+        m_NumberOfChunks = m_Splitter->GetNumberOfSplits(m_ChunkedRegion,
+                                                         this->GetNumberOfThreads() * m_NumberOfChunksPerThread);
+        m_NextChunk = 0;
+        m_CompletedChunks = 0;
+
+        typename MultiThreader::Pointer threader = this->GetMultiThreader();
+        threader->SetNumberOfThreads(this->GetNumberOfThreads());
+        threader->SetSingleMethod(Self::chunkThreaderCallback, this);
+        threader->SingleMethodExecute();
+
+        this->AfterThreadedGenerateData();
+    }
+
+    template<typename TSuperclass>
+    ITK_THREAD_RETURN_TYPE DynamicThreadedImageFilter<TSuperclass>
+    ::chunkThreaderCallback(void *arg) {
+        MultiThreader::ThreadInfoStruct *info = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+        static_cast<Self *>(info->UserData)->processChunks(info->ThreadID);
+        return ITK_THREAD_RETURN_VALUE;
+    }
+
+    template<typename TSuperclass>
+    void DynamicThreadedImageFilter<TSuperclass>
+    ::processChunks(ThreadIdType workerId) {
+        for (unsigned int i = m_NextChunk++; i < m_NumberOfChunks; i = m_NextChunk++) {
+            OutputImageRegionType chunk = m_ChunkedRegion;
+            m_Splitter->GetSplit(i, m_NumberOfChunks, chunk);
+            // thread 0 is never passed on, its reporters would restart at 0 for every chunk
+            this->ThreadedGenerateData(chunk, workerId + 1);
+
+            const unsigned int completed = ++m_CompletedChunks;
+            if (workerId == 0) {
+                this->UpdateProgress(static_cast<float>(completed) / m_NumberOfChunks);
+            }
+        }
+    }
+
+    template<typename TSuperclass>
+    void DynamicThreadedImageFilter<TSuperclass>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "NumberOfChunksPerThread: " << m_NumberOfChunksPerThread << std::endl;
+        os << indent << "NumberOfChunks: " << m_NumberOfChunks << std::endl;
+    }
+}
+
+#endif // __DynamicThreadedImageFilter_hxx_
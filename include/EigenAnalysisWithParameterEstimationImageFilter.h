@@ -0,0 +1,156 @@
+#ifndef EigenAnalysisWithParameterEstimationImageFilter_h
+#define EigenAnalysisWithParameterEstimationImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkSymmetricEigenAnalysisImageFilter.h"
+#include "SheetnessParameterStatistics.h"
+
+namespace itk
+{
+
+/** \class EigenAnalysisWithParameterEstimationImageFilter
+ * SymmetricEigenAnalysisImageFilter that also does the work of AutomaticSheetnessParameterEstimationImageFilter.
+ *
+ * While the eigenvalues of a voxel are computed and still in registers, their Frobenius norm is folded into a
+ * per-thread maximum (or QuantileSketch with UseQuantile on), restricted to Label in the optional label input.
+ * After the update the eigenvalue image is the output and C = Scale * max norm is known, so the sheetness filter
+ * can run directly on the output without a separate estimation sweep over the eigenvalue image.
+ *
+ * The statistic is the one of AutomaticSheetnessParameterEstimationImageFilter, with the same SamplingMode,
+ * NumberOfSamples and Seed: every eigenvalue is computed and written, but only the sampled ones enter the norm
+ * statistic. With equal settings both filters give the same C and error report.
+ */
+template <class TInputImage, class TOutputImage, class TLabelImage>
+class ITK_EXPORT EigenAnalysisWithParameterEstimationImageFilter : public ImageToImageFilter<TInputImage, TOutputImage> {
+public:
+  /** Standard class typedefs. */
+  typedef EigenAnalysisWithParameterEstimationImageFilter    Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage>      Superclass;
+  typedef SmartPointer<Self>                Pointer;
+  typedef SmartPointer<const Self>          ConstPointer;
+  typedef typename TLabelImage::PixelType TLabelPixelType;
+  typedef typename TInputImage::PixelType InputPixelType;
+  typedef typename TOutputImage::PixelType OutputPixelType;
+  typedef Functor::SymmetricEigenAnalysisFunction<InputPixelType, OutputPixelType> EigenAnalysisFunctorType;
+  typedef typename EigenAnalysisFunctorType::EigenValueOrderType EigenValueOrderType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(EigenAnalysisWithParameterEstimationImageFilter, ImageToImageFilter);
+
+  /** Dimension of the matrices, as in SymmetricEigenAnalysisImageFilter. */
+  void SetDimension(unsigned int n) {
+    m_Functor.SetDimension(n);
+    this->Modified();
+  }
+
+  /** Order of the eigenvalues, as in SymmetricEigenAnalysisImageFilter. */
+  void OrderEigenValuesBy(EigenValueOrderType order) {
+    m_Functor.OrderEigenValuesBy(order);
+    this->Modified();
+  }
+
+  itkSetMacro(Label,TLabelPixelType);
+  itkGetMacro(Label,TLabelPixelType);
+
+  itkSetMacro(Scale,double);
+  itkGetMacro(Scale,double);
+
+  itkSetMacro(UseQuantile,bool);
+  itkGetMacro(UseQuantile,bool);
+  itkBooleanMacro(UseQuantile);
+
+  itkSetClampMacro(Quantile,double,0.0,1.0);
+  itkGetMacro(Quantile,double);
+
+  typedef enum {
+    FullSampling = 0,
+    StrideSampling,
+    RandomSampling
+  } SamplingModeType;
+
+  itkSetMacro(SamplingMode,SamplingModeType);
+  itkGetMacro(SamplingMode,SamplingModeType);
+
+  /** Number of voxels in the statistic with StrideSampling or RandomSampling, before the label is applied. */
+  itkSetMacro(NumberOfSamples,SizeValueType);
+  itkGetMacro(NumberOfSamples,SizeValueType);
+
+  itkSetMacro(Seed,unsigned int);
+  itkGetMacro(Seed,unsigned int);
+
+  /** Error report of the last update, as in AutomaticSheetnessParameterEstimationImageFilter. */
+  itkGetMacro(NumberOfSampledPixels,SizeValueType);
+  itkGetMacro(CLowerBound,double);
+  itkGetMacro(CUpperBound,double);
+  itkGetMacro(ExceedanceFraction,double);
+
+  itkGetMacro(Alpha,double);
+  itkGetMacro(Beta,double);
+  itkGetMacro(C,double);
+
+  void SetLabelInput(const TLabelImage *input) {
+    // Process object is not const-correct so the const casting is required.
+    this->SetNthInput( 1, const_cast< TLabelImage * >( input ) );
+  }
+
+  const TLabelImage * GetLabelInput() const{
+    return itkDynamicCastInDebugMode< TLabelImage * >( const_cast< DataObject * >( this->ProcessObject::GetInput(1) ) );
+  }
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro(BracketOperatorsCheck,
+    (Concept::BracketOperator< OutputPixelType, unsigned int, double >));
+  /** End concept checking */
+#endif
+
+protected:
+  EigenAnalysisWithParameterEstimationImageFilter();
+  virtual ~EigenAnalysisWithParameterEstimationImageFilter() {}
+
+  /** C is a statistic of the whole image, it cannot be streamed. */
+  void EnlargeOutputRequestedRegion(DataObject *data) ITK_OVERRIDE;
+
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+  void ThreadedGenerateData(const typename TOutputImage::RegionType & outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+private:
+  EigenAnalysisWithParameterEstimationImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  EigenAnalysisFunctorType m_Functor;
+
+  // Parameters
+  double m_Alpha;
+  double m_Beta;
+  double m_C;
+  double m_Scale;
+  TLabelPixelType m_Label;
+  bool m_UseQuantile;
+  double m_Quantile;
+  SamplingModeType m_SamplingMode;
+  SizeValueType m_NumberOfSamples;
+  unsigned int m_Seed;
+
+  // Error report
+  SizeValueType m_NumberOfSampledPixels;
+  double m_CLowerBound;
+  double m_CUpperBound;
+  double m_ExceedanceFraction;
+
+  // Per-thread maximum, count and sketch of the squared norm
+  SheetnessParameterStatistics m_Statistics;
+}; // class EigenAnalysisWithParameterEstimationImageFilter
+
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "EigenAnalysisWithParameterEstimationImageFilter.hxx"
+#endif
+
+#endif /* EigenAnalysisWithParameterEstimationImageFilter_h */
@@ -0,0 +1,111 @@
+#ifndef _EigenAnalysisWithParameterEstimationImageFilter_hxx_
+#define _EigenAnalysisWithParameterEstimationImageFilter_hxx_
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+
+namespace itk {
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    EigenAnalysisWithParameterEstimationImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::EigenAnalysisWithParameterEstimationImageFilter()
+        : m_Alpha(0.5f), m_Beta(0.5f), m_C(0.5f),
+        m_Scale(0.1f), m_Label(1.0f),
+        m_UseQuantile(false), m_Quantile(0.99),
+        m_SamplingMode(FullSampling), m_NumberOfSamples(2000000), m_Seed(0),
+        m_NumberOfSampledPixels(0), m_CLowerBound(0), m_CUpperBound(0), m_ExceedanceFraction(0)
+    {
+        this->SetNumberOfRequiredInputs(1);
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void EigenAnalysisWithParameterEstimationImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::EnlargeOutputRequestedRegion(DataObject *data) {
+        Superclass::EnlargeOutputRequestedRegion(data);
+        data->SetRequestedRegionToLargestPossibleRegion();
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void EigenAnalysisWithParameterEstimationImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::BeforeThreadedGenerateData() {
+        // The voxels are sampled by their offset in the output buffer, the label buffer has to match it
+        const TOutputImage *output = this->GetOutput();
+        if (this->GetLabelInput() != ITK_NULLPTR &&
+            this->GetLabelInput()->GetBufferedRegion() != output->GetBufferedRegion()) {
+            itkExceptionMacro(<< "The label image has to cover the same region as the output");
+        }
+
+        m_Statistics.Initialize(this->GetNumberOfThreads(), m_UseQuantile,
+                                output->GetBufferedRegion().GetNumberOfPixels(), output->GetBufferedRegion().GetSize(0),
+                                m_SamplingMode == FullSampling ? 0 : m_NumberOfSamples,
+                                m_SamplingMode == RandomSampling, m_Seed);
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void EigenAnalysisWithParameterEstimationImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::ThreadedGenerateData(const typename TOutputImage::RegionType & outputRegionForThread, ThreadIdType threadId) {
+        const SizeValueType length = outputRegionForThread.GetSize(0);
+        if (length == 0) {
+            return;
+        }
+
+        const TInputImage *input = this->GetInput();
+        TOutputImage *output = this->GetOutput();
+        const TLabelPixelType *labels = this->GetLabelInput() != ITK_NULLPTR ?
+                                        this->GetLabelInput()->GetBufferPointer() : ITK_NULLPTR;
+        const IndexValueType rowStart = output->GetBufferedRegion().GetIndex(0);
+
+        // Compare squared norms, the square root is taken once on the merged result
+        SheetnessParameterStatistics::ThreadStatistics statistics = m_Statistics.GetThreadStatistics(threadId);
+
+        // Eigenvalues of a line, then the norms of its sampled voxels while the line is in cache
+        ImageLinearConstIteratorWithIndex<TOutputImage> it(output, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const typename TOutputImage::IndexType index = it.GetIndex();
+            const InputPixelType *in = input->GetBufferPointer() + input->ComputeOffset(index);
+            const OffsetValueType begin = output->ComputeOffset(index);
+            OutputPixelType *out = output->GetBufferPointer() + begin;
+            for (SizeValueType i = 0; i < length; ++i) {
+                out[i] = m_Functor(in[i]);
+            }
+            m_Statistics.InsertSamples(begin, begin + static_cast<OffsetValueType>(length),
+                                       begin - (index[0] - rowStart), output->GetBufferPointer(), labels, m_Label,
+                                       statistics);
+        }
+        m_Statistics.AddThreadStatistics(threadId, statistics);
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void EigenAnalysisWithParameterEstimationImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::AfterThreadedGenerateData() {
+        // Merge the per-thread statistics and set C
+        m_Statistics.Merge(this->GetScale(), m_Quantile);
+        m_C = m_Statistics.GetC();
+        m_CLowerBound = m_Statistics.GetCLowerBound();
+        m_CUpperBound = m_Statistics.GetCUpperBound();
+        m_ExceedanceFraction = m_Statistics.GetExceedanceFraction();
+        m_NumberOfSampledPixels = m_Statistics.GetNumberOfSampledPixels();
+        if (this->GetLabelInput() != ITK_NULLPTR && m_NumberOfSampledPixels == 0) {
+            itkWarningMacro(<< "No voxel with label " << static_cast<double>(m_Label) << ", C is set to 0");
+        }
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void EigenAnalysisWithParameterEstimationImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::PrintSelf(std::ostream & os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Scale: " << m_Scale << std::endl;
+        os << indent << "Label: " << static_cast<double>(m_Label) << std::endl;
+        os << indent << "UseQuantile: " << m_UseQuantile << std::endl;
+        os << indent << "Quantile: " << m_Quantile << std::endl;
+        os << indent << "SamplingMode: " << m_SamplingMode << std::endl;
+        os << indent << "NumberOfSamples: " << m_NumberOfSamples << std::endl;
+        os << indent << "Seed: " << m_Seed << std::endl;
+        os << indent << "Alpha: " << m_Alpha << std::endl;
+        os << indent << "Beta: " << m_Beta << std::endl;
+        os << indent << "C: " << m_C << " [" << m_CLowerBound << ", " << m_CUpperBound << "]" << std::endl;
+        os << indent << "NumberOfSampledPixels: " << m_NumberOfSampledPixels << std::endl;
+        os << indent << "ExceedanceFraction: " << m_ExceedanceFraction << std::endl;
+    }
+}
+
+#endif /* _EigenAnalysisWithParameterEstimationImageFilter_hxx_ */
@@ -1,7 +1,9 @@
 #ifndef FrobeniusNormImageFilter_h
 #define FrobeniusNormImageFilter_h
 
+#include "itkUnaryFunctorImageFilter.h"
 #include "vnl/vnl_math.h"
+#include "DynamicThreadedImageFilter.h"
 
 namespace itk
 {
@@ -39,18 +41,18 @@ public:
 template <class TInputImage, class TOutputImage>
 class ITK_EXPORT FrobeniusNormImageFilter :
     public
-UnaryFunctorImageFilter<TInputImage,TOutputImage, 
+DynamicThreadedImageFilter<UnaryFunctorImageFilter<TInputImage,TOutputImage, 
                         Function::FrobeniusMatrixNorm< typename TInputImage::PixelType, 
-                                       typename TOutputImage::PixelType>   >
+                                       typename TOutputImage::PixelType>   > >
 {
     public:
   /** Standard class typedefs. */
   typedef FrobeniusNormImageFilter    Self;
-  typedef UnaryFunctorImageFilter<
+  typedef DynamicThreadedImageFilter<UnaryFunctorImageFilter<
     TInputImage,TOutputImage, 
     Function::FrobeniusMatrixNorm< 
       typename TInputImage::PixelType, 
-      typename TOutputImage::PixelType> >   Superclass;
+      typename TOutputImage::PixelType> > >   Superclass;
   typedef SmartPointer<Self>                Pointer;
   typedef SmartPointer<const Self>          ConstPointer;
 
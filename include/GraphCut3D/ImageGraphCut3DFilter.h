@@ -20,6 +20,7 @@
 #include "itkHistogram.h"
 #include "itkListSample.h"
 #include "itkProgressReporter.h"
+#include "itkTimeProbesCollectorBase.h"
 
 // STL
 #include <vector>
@@ -27,6 +28,12 @@
 // Graph
 #include "MaxFlowGraphKolmogorov.hxx"
 
+// Telemetry
+#include "PerformanceTelemetry.h"
+
+// Boundary term
+#include "FastExp.h"
+
 namespace itk {
     template<typename TInput, typename TForeground, typename TBackground, typename TOutput>
     class ITK_EXPORT ImageGraphCut3DFilter : public ImageToImageFilter<TInput, TOutput> {
@@ -63,6 +70,11 @@ namespace itk {
             m_Lambda = d;
         }
 
+        // evaluate the boundary term with FastExp, relative error below FastExpMaximumRelativeError
+        void SetUseFastExp(bool b) {
+            m_UseFastExp = b;
+        }
+
         void SetTerminalWeight(float f) {
             m_TerminalWeight = f;
         }
@@ -104,6 +116,54 @@ namespace itk {
             m_PrintTimer = b;
         }
 
+        // record every stage as a telemetry stage in addition to the verbose timer output
+        void SetTelemetry(PerformanceTelemetry *t) {
+            m_Telemetry = t;
+        }
+
+        // measure growth / augment / adopt time inside the max-flow computation (adds a clock read per active node)
+        void SetMaxFlowPhaseTiming(bool b) {
+            m_MaxFlowPhaseTiming = b;
+        }
+
+        // max-flow statistics of the last update
+        typedef MaxFlowGraphKolmogorov::GraphType::maxflow_stats MaxFlowStatisticsType;
+
+        const MaxFlowStatisticsType &GetMaxFlowStatistics() const {
+            return m_MaxFlowStatistics;
+        }
+
+        long long GetNumberOfAugmentingPaths() const {
+            return m_MaxFlowStatistics.augmentations;
+        }
+
+        long long GetNumberOfOrphans() const {
+            return m_MaxFlowStatistics.orphans;
+        }
+
+        long long GetNumberOfActiveNodePushes() const {
+            return m_MaxFlowStatistics.active_pushes;
+        }
+
+        double GetMaxFlow() const {
+            return m_MaxFlowStatistics.flow;
+        }
+
+        size_t GetPeakGraphMemory() const {
+            return m_MaxFlowStatistics.peak_bytes;
+        }
+
+        double GetGrowthTime() const {
+            return m_MaxFlowStatistics.growth_time;
+        }
+
+        double GetAugmentTime() const {
+            return m_MaxFlowStatistics.augment_time;
+        }
+
+        double GetAdoptTime() const {
+            return m_MaxFlowStatistics.adopt_time;
+        }
 
     protected:
         struct ImageContainer {
@@ -129,6 +189,12 @@ namespace itk {
 
         void CutGraph(GraphType *, ImageContainer, ProgressReporter &progress);
 
+        // start / stop a stage in both the timer and the telemetry
+        void StartStage(TimeProbesCollectorBase &timer, const std::string &stage);
+
+        void StopStage(TimeProbesCollectorBase &timer, const std::string &stage, SizeValueType numberOfVoxels,
+                       SizeValueType numberOfBytes);
+
         // convert masks to >0 indices
         template<typename TIndexImage>
         std::vector<itk::Index<3> > getPixelsLargerThanZero(const TIndexImage *const);
@@ -158,6 +224,10 @@ namespace itk {
         bool m_PrintTimer;
         double m_Lambda; // Boundary term weight
         float m_TerminalWeight; //source/sink terminal value
+        bool m_MaxFlowPhaseTiming;
+        bool m_UseFastExp;
+        MaxFlowStatisticsType m_MaxFlowStatistics;
+        PerformanceTelemetry::Pointer m_Telemetry;
 
 
     private:
@@ -22,7 +22,10 @@ namespace itk {
               m_BackgroundPixelValue(0),
               m_PrintTimer(false),
               m_Lambda(5.0),
-              m_TerminalWeight(1.0){
+              m_TerminalWeight(1.0),
+              m_MaxFlowPhaseTiming(false),
+              m_UseFastExp(false),
+              m_MaxFlowStatistics(){
         this->SetNumberOfRequiredInputs(3);
     }
 
@@ -36,7 +39,7 @@ namespace itk {
     ::GenerateData() {
         itk::TimeProbesCollectorBase timer;
 
-        timer.Start("ITK init");
+        StartStage(timer, "ITK init");
         // get all images
         ImageContainer images;
         images.input = GetInputImage();
@@ -66,28 +69,41 @@ namespace itk {
 
         // get the total image size
         typename InputImageType::SizeType size = images.inputRegion.GetSize();
-        timer.Stop("ITK init");
+        StopStage(timer, "ITK init", numberOfPixelDuringOutput,
+                  PerformanceTelemetry::GetImageBufferSize(images.output.GetPointer()));
 
         // create graph
-        timer.Start("Graph creation");
+        StartStage(timer, "Graph creation");
         GraphType graph(size[0], size[1], size[2]);
-        timer.Stop("Graph creation");
+        StopStage(timer, "Graph creation", numberOfPixelDuringInit, 0);
 
-        timer.Start("Graph init");
+        StartStage(timer, "Graph init");
         InitializeGraph(&graph, images, progress);
-        timer.Stop("Graph init");
+        StopStage(timer, "Graph init", numberOfPixelDuringInit, 0);
 
         // cut graph
-        timer.Start("Graph cut");
+        StartStage(timer, "Graph cut");
+        graph.setPhaseTimingEnabled(m_MaxFlowPhaseTiming);
         graph.calculateMaxFlow();
-        timer.Stop("Graph cut");
+        m_MaxFlowStatistics = graph.getStatistics();
+        StopStage(timer, "Graph cut", numberOfPixelDuringInit, m_MaxFlowStatistics.peak_bytes);
 
-        timer.Start("Query results");
+        StartStage(timer, "Query results");
         CutGraph(&graph, images, progress);
-        timer.Stop("Query results");
+        StopStage(timer, "Query results", numberOfPixelDuringOutput, 0);
 
         if (m_PrintTimer) {
             timer.Report(std::cout);
+            std::cout << "Max flow: " << m_MaxFlowStatistics.flow
+                      << ", augmenting paths: " << m_MaxFlowStatistics.augmentations
+                      << ", orphans: " << m_MaxFlowStatistics.orphans
+                      << ", active node pushes: " << m_MaxFlowStatistics.active_pushes
+                      << ", peak graph memory: " << m_MaxFlowStatistics.peak_bytes << " bytes" << std::endl;
+            if (m_MaxFlowPhaseTiming) {
+                std::cout << "Growth: " << m_MaxFlowStatistics.growth_time
+                          << " s, augment: " << m_MaxFlowStatistics.augment_time
+                          << " s, adopt: " << m_MaxFlowStatistics.adopt_time << " s" << std::endl;
+            }
         }
     }
 
@@ -140,7 +156,8 @@ namespace itk {
                 }
 
                 // Compute the edge weight
-                double weight = m_Lambda * exp(-std::abs(centerPixel - neighborPixel) /  m_Sigma);
+                const double boundary = -std::abs(centerPixel - neighborPixel) / m_Sigma;
+                double weight = m_Lambda * (m_UseFastExp ? FastExp(boundary) : exp(boundary));
                 assert(weight >= 0);
                 double otherWeight = m_Lambda * 1.0; //Needed for directional boundary term
 
@@ -202,6 +219,26 @@ namespace itk {
         }
     }
 
+    template<typename TImage, typename TForeground, typename TBackground, typename TOutput>
+    void ImageGraphCut3DFilter<TImage, TForeground, TBackground, TOutput>
+    ::StartStage(TimeProbesCollectorBase &timer, const std::string &stage) {
+        timer.Start(stage.c_str());
+        if (m_Telemetry) {
+            m_Telemetry->StartStage(stage);
+        }
+    }
+
+    template<typename TImage, typename TForeground, typename TBackground, typename TOutput>
+    void ImageGraphCut3DFilter<TImage, TForeground, TBackground, TOutput>
+    ::StopStage(TimeProbesCollectorBase &timer, const std::string &stage, SizeValueType numberOfVoxels,
+                SizeValueType numberOfBytes) {
+        timer.Stop(stage.c_str());
+        if (m_Telemetry) {
+            // the max flow library is single threaded, so are the ITK parts of this filter
+            m_Telemetry->StopStage(stage, numberOfVoxels, numberOfBytes, 1);
+        }
+    }
+
     template<typename TImage, typename TForeground, typename TBackground, typename TOutput>
     template<typename TIndexImage>
     std::vector<itk::Index<3> > ImageGraphCut3DFilter<TImage, TForeground, TBackground, TOutput>
@@ -43,9 +43,19 @@ public:
         graph->add_tweights(node, sourceWeight, sinkWeight);
     }
 
-    // start the calculation
-    void calculateMaxFlow(){
-        graph->maxflow();
+    // start the calculation, returns the value of the maximum flow
+    float calculateMaxFlow(){
+        return graph->maxflow();
+    }
+
+    // measure the time spent in the growth, augmentation and adoption stages during calculateMaxFlow()
+    void setPhaseTimingEnabled(bool enabled){
+        graph->enable_phase_timing(enabled);
+    }
+
+    // statistics of the last calculateMaxFlow() call
+    const GraphType::maxflow_stats& getStatistics(){
+        return graph->get_stats();
     }
 
     // query the resulting segmentation group of a vertex. 
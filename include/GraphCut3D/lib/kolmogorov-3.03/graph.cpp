@@ -16,7 +16,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 	Graph<captype, tcaptype, flowtype>::Graph(int node_num_max, int edge_num_max, void (*err_function)(const char *))
 	: node_num(0),
 	  nodeptr_block(NULL),
-	  error_function(err_function)
+	  error_function(err_function),
+	  phase_timing(false)
 {
 	if (node_num_max < 16) node_num_max = 16;
 	if (edge_num_max < 16) edge_num_max = 16;
@@ -32,6 +33,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 	maxflow_iteration = 0;
 	flow = 0;
+	reset_stats();
 }
 
 template <typename captype, typename tcaptype, typename flowtype> 
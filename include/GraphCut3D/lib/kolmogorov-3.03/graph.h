@@ -268,6 +268,29 @@ public:
 		nodes[i].is_in_changed_list = 0;
 	}
 
+	////////////////////////////////////
+	// 6. Max-flow instrumentation.   //
+	////////////////////////////////////
+
+	// Counters collected during the last call to maxflow(). They are always
+	// gathered since they only cost an increment each. The phase timings are
+	// only measured if enable_phase_timing(true) was called before maxflow(),
+	// because reading the clock for every active node is not free.
+	struct maxflow_stats
+	{
+		long long	augmentations;		// number of augmenting paths found
+		long long	orphans;			// number of orphans processed by the adoption stage
+		long long	active_pushes;		// number of nodes appended to the active list
+		flowtype	flow;				// value of the maximum flow
+		size_t		peak_bytes;			// nodes + arcs + peak size of the orphan list, in bytes
+		double		growth_time;		// seconds spent in the growth stage
+		double		augment_time;		// seconds spent in the augmentation stage
+		double		adopt_time;			// seconds spent in the adoption stage
+	};
+
+	const maxflow_stats& get_stats() { return stats; }
+	void enable_phase_timing(bool enable) { phase_timing = enable; }
+
 
 
 
@@ -339,6 +362,12 @@ private:
 
 	/////////////////////////////////////////////////////////////////////////
 
+	maxflow_stats		stats;
+	bool				phase_timing;
+	long long			orphan_count, orphan_count_max;	// current and peak length of the orphan list
+
+	/////////////////////////////////////////////////////////////////////////
+
 	void reallocate_nodes(int num); // num is the number of new nodes
 	void reallocate_arcs();
 
@@ -352,6 +381,7 @@ private:
 
 	void add_to_changed_list(node* i);
 
+	void reset_stats();
 	void maxflow_init();             // called if reuse_trees == false
 	void maxflow_reuse_trees_init(); // called if reuse_trees == true
 	void augment(arc *middle_arc);
@@ -2,6 +2,7 @@
 
 
 #include <stdio.h>
+#include <chrono>
 #include "graph.h"
 
 
@@ -14,6 +15,12 @@
 
 #define INFINITE_D ((int)(((unsigned)-1)/2))		/* infinite distance to the terminal */
 
+/* wall clock in seconds, used for the optional phase timing */
+static inline double stats_clock()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 /***********************************************************************/
 
 /*
@@ -40,6 +47,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 		else               queue_first[1]        = i;
 		queue_last[1] = i;
 		i -> next = i;
+		stats.active_pushes ++;
 	}
 }
 
@@ -82,6 +90,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 	nodeptr *np;
 	i -> parent = ORPHAN;
 	np = nodeptr_block -> New();
+	if (++orphan_count > orphan_count_max) orphan_count_max = orphan_count;
 	np -> ptr = i;
 	np -> next = orphan_first;
 	orphan_first = np;
@@ -93,6 +102,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 	nodeptr *np;
 	i -> parent = ORPHAN;
 	np = nodeptr_block -> New();
+	if (++orphan_count > orphan_count_max) orphan_count_max = orphan_count;
 	np -> ptr = i;
 	if (orphan_last) orphan_last -> next = np;
 	else             orphan_first        = np;
@@ -115,6 +125,13 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 /***********************************************************************/
 
+template <typename captype, typename tcaptype, typename flowtype> 
+	void Graph<captype,tcaptype,flowtype>::reset_stats()
+{
+	memset(&stats, 0, sizeof(stats));
+	orphan_count = orphan_count_max = 0;
+}
+
 template <typename captype, typename tcaptype, typename flowtype> 
 	void Graph<captype,tcaptype,flowtype>::maxflow_init()
 {
@@ -231,6 +248,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 		orphan_first = np -> next;
 		i = np -> ptr;
 		nodeptr_block -> Delete(np);
+		orphan_count --;
+		stats.orphans ++;
 		if (!orphan_first) orphan_last = NULL;
 		if (i->is_sink) process_sink_orphan(i);
 		else            process_source_orphan(i);
@@ -474,6 +493,7 @@ template <typename captype, typename tcaptype, typename flowtype>
 	node *i, *j, *current_node = NULL;
 	arc *a;
 	nodeptr *np, *np_next;
+	double t_phase = 0, t;
 
 	if (!nodeptr_block)
 	{
@@ -484,6 +504,9 @@ template <typename captype, typename tcaptype, typename flowtype>
 	if (maxflow_iteration == 0 && reuse_trees) { if (error_function) (*error_function)("reuse_trees cannot be used in the first call to maxflow()!"); exit(1); }
 	if (changed_list && !reuse_trees) { if (error_function) (*error_function)("changed_list cannot be used without reuse_trees!"); exit(1); }
 
+	reset_stats();
+	if (phase_timing) t_phase = stats_clock();
+
 	if (reuse_trees) maxflow_reuse_trees_init();
 	else             maxflow_init();
 
@@ -560,6 +583,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 		TIME ++;
 
+		if (phase_timing) { t = stats_clock(); stats.growth_time += t - t_phase; t_phase = t; }
+
 		if (a)
 		{
 			i -> next = i; /* set active flag */
@@ -567,8 +592,11 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 			/* augmentation */
 			augment(a);
+			stats.augmentations ++;
 			/* augmentation end */
 
+			if (phase_timing) { t = stats_clock(); stats.augment_time += t - t_phase; t_phase = t; }
+
 			/* adoption */
 			while ((np=orphan_first))
 			{
@@ -580,6 +608,8 @@ template <typename captype, typename tcaptype, typename flowtype>
 					orphan_first = np -> next;
 					i = np -> ptr;
 					nodeptr_block -> Delete(np);
+					orphan_count --;
+					stats.orphans ++;
 					if (!orphan_first) orphan_last = NULL;
 					if (i->is_sink) process_sink_orphan(i);
 					else            process_source_orphan(i);
@@ -588,11 +618,18 @@ template <typename captype, typename tcaptype, typename flowtype>
 				orphan_first = np_next;
 			}
 			/* adoption end */
+
+			if (phase_timing) { t = stats_clock(); stats.adopt_time += t - t_phase; t_phase = t; }
 		}
 		else current_node = NULL;
 	}
 	// test_consistency();
 
+	stats.flow = flow;
+	stats.peak_bytes = (size_t)(node_max - nodes) * sizeof(node)
+	                 + (size_t)(arc_max - arcs) * sizeof(arc)
+	                 + (size_t)orphan_count_max * sizeof(nodeptr);
+
 	if (!reuse_trees || (maxflow_iteration % 64) == 0)
 	{
 		delete nodeptr_block; 
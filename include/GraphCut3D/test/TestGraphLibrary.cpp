@@ -364,4 +364,61 @@ TEST_F(TestGraphLibrary, MaxFlowGraphKolmogorov){
     // both containers should now be empty
     EXPECT_EQ(0, expectedForeground.size());
     EXPECT_EQ(0, expectedBackground.size());
-}
\ No newline at end of file
+}
+
+TEST_F(TestGraphLibrary, MaxFlowGraphKolmogorovStatistics){
+    // same example as in MaxFlowGraphKolmogorov, checks the counters collected during the max flow computation
+    float smallWeight = 1;
+    float largeWeight = 1000;
+
+    MaxFlowGraphKolmogorov graph(3, 5, 1);
+    graph.setPhaseTimingEnabled(true);
+
+    graph.addBidirectionalEdge(0, 1, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(1, 2, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(2, 3, smallWeight, smallWeight);
+    graph.addBidirectionalEdge(3, 4, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(5, 6, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(6, 7, smallWeight, smallWeight);
+    graph.addBidirectionalEdge(7, 8, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(8, 9, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(10, 11, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(11, 12, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(12, 13, smallWeight, smallWeight);
+    graph.addBidirectionalEdge(13, 14, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(0, 5, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(1, 6, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(2, 7, smallWeight, smallWeight);
+    graph.addBidirectionalEdge(3, 8, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(4, 9, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(5, 10, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(6, 11, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(7, 12, smallWeight, smallWeight);
+    graph.addBidirectionalEdge(8, 13, largeWeight, largeWeight);
+    graph.addBidirectionalEdge(9, 14, largeWeight, largeWeight);
+
+    std::vector<unsigned int> sourceNodes = boost::assign::list_of(0)(1)(6)(10)(11);
+    for(int i = 0; i < sourceNodes.size(); ++i){
+        graph.addTerminalEdges(sourceNodes[i], largeWeight, smallWeight);
+    }
+    std::vector<unsigned int> sinkNodes = boost::assign::list_of(3)(4)(8)(13)(14);
+    for(int i = 0; i < sinkNodes.size(); ++i){
+        graph.addTerminalEdges(sinkNodes[i], smallWeight, largeWeight);
+    }
+
+    float flow = graph.calculateMaxFlow();
+    const MaxFlowGraphKolmogorov::GraphType::maxflow_stats& stats = graph.getStatistics();
+
+    // 10 from the small terminal weights plus the 5 small edges of the minimum cut
+    EXPECT_FLOAT_EQ(15, flow);
+    EXPECT_FLOAT_EQ(flow, stats.flow);
+
+    // every augmenting path across the cut carries one unit of flow
+    EXPECT_EQ(5, stats.augmentations);
+    EXPECT_GE(stats.active_pushes, graph.getNumberOfVertices());
+    EXPECT_GE(stats.orphans, 0);
+    EXPECT_GT(stats.peak_bytes, 0u);
+    EXPECT_GE(stats.growth_time, 0);
+    EXPECT_GE(stats.augment_time, 0);
+    EXPECT_GE(stats.adopt_time, 0);
+}
@@ -13,9 +13,13 @@
 #include <itkImage.h>
 #include <itkSubtractImageFilter.h>
 #include <itkStatisticsImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+
+#include <cmath>
 
 #include "IOHelper.hxx"
 #include "ImageGraphCut3DFilter.h"
+#include "FastExp.h"
 
 class TestSegmentation : public ::testing::Test {
 protected:
@@ -197,6 +201,68 @@ TEST_F(TestSegmentation, FemurGraphCutTest){
     ASSERT_DOUBLE_EQ(0, pixelSum);
 }
 
+TEST_F(TestSegmentation, FemurGraphCutFastExpTest){
+    // path to files
+    std::string inputPath = "data/test/left_femur/input.nrrd";
+    std::string forgroundPath = "data/test/left_femur/foreground.nrrd";
+    std::string backgroundPath = "data/test/left_femur/background.nrrd";
+    std::string expectedPath = "data/test/left_femur/expectedResult.nrrd";
+
+    // read the images
+    TInput::Pointer inputImage = IOHelper::readImage<TInput>(inputPath.c_str());
+    TForeground::Pointer foregroundMask = IOHelper::readImage<TForeground>(forgroundPath.c_str());
+    TBackground::Pointer backgroundMask = IOHelper::readImage<TBackground>(backgroundPath.c_str());
+    TOutput::Pointer expectedResultImage = IOHelper::readImage<TOutput>(expectedPath.c_str());
+
+    // set images
+    graphCutFilter->SetInputImage(inputImage);
+    graphCutFilter->SetForegroundImage(foregroundMask);
+    graphCutFilter->SetBackgroundImage(backgroundMask);
+
+    // set parameters, the same as FemurGraphCutTest with the fast boundary term
+    graphCutFilter->SetForegroundPixelValue(255);
+    graphCutFilter->SetBackgroundPixelValue(0);
+    graphCutFilter->SetSigma(50.0);
+    graphCutFilter->SetBoundaryDirectionTypeToNoDirection();
+    graphCutFilter->SetUseFastExp(true);
+    graphCutFilter->Update();
+
+    // The boundary weights are within FastExpMaximumRelativeError of the exact ones, so every cut costs the same up
+    // to that relative error and the fast cut is a near-optimal cut of the exact graph. Where it differs, it moves
+    // the surface locally: a changed voxel lies on the surface of the expected result, and there are at most as many
+    // changed voxels as the error is of the surface voxels, rounded up.
+    TOutput::Pointer resultImage = graphCutFilter->GetOutput();
+    const TOutput::RegionType region = expectedResultImage->GetLargestPossibleRegion();
+    itk::ImageRegionConstIterator<TOutput> resultIt(resultImage, region);
+    itk::ImageRegionConstIterator<TOutput> expectedIt(expectedResultImage, region);
+    unsigned long numberOfSurfaceVoxels = 0;
+    unsigned long numberOfChangedVoxels = 0;
+    for (; !resultIt.IsAtEnd(); ++resultIt, ++expectedIt) {
+        // a voxel with a 6-neighbour of the other label in the expected result
+        const TOutput::IndexType index = expectedIt.GetIndex();
+        bool surface = false;
+        for (unsigned int d = 0; d < 3; ++d) {
+            for (int step = -1; step <= 1; step += 2) {
+                TOutput::IndexType neighbor = index;
+                neighbor[d] += step;
+                if (region.IsInside(neighbor) && expectedResultImage->GetPixel(neighbor) != expectedIt.Get()) {
+                    surface = true;
+                }
+            }
+        }
+        if (surface) {
+            ++numberOfSurfaceVoxels;
+        }
+        if (resultIt.Get() != expectedIt.Get()) {
+            ++numberOfChangedVoxels;
+            ASSERT_TRUE(surface) << "at " << index;
+        }
+    }
+    ASSERT_GT(numberOfSurfaceVoxels, 0u);
+    ASSERT_LE(numberOfChangedVoxels,
+              static_cast<unsigned long>(std::ceil(numberOfSurfaceVoxels * itk::FastExpMaximumRelativeError)));
+}
+
 TEST_F(TestSegmentation, SetPixelValues){
     // path to files
     std::string inputPath = "data/test/cube10x10x10/cube.mhd";
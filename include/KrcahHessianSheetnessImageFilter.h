@@ -0,0 +1,138 @@
+#ifndef __KrcahHessianSheetnessImageFilter_h_
+#define __KrcahHessianSheetnessImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "itkImage.h"
+#include "itkSymmetricEigenAnalysis.h"
+#include "itkFixedArray.h"
+#include "KrcahSheetnessFunctor.h"
+#include "DynamicThreadedImageFilter.h"
+
+#include <vector>
+
+namespace itk {
+    /*
+     * Krcah sheetness straight from the Hessian, the eigenvalues are computed per line and never stored as an image.
+     *
+     * Voxels with a Frobenius norm ||H||_F below SkipThreshold * |T| are set to 0 without eigen decomposition and
+     * exponentials. The sheetness is bounded by the noise term, 1 - exp(-Rnoise^2 / gamma^2) <= Rnoise^2 / gamma^2,
+     * and Rnoise = (|l1| + ... + |lD|) / T <= sqrt(D) ||H||_F / |T| in D dimensions, so the error of a skipped voxel
+     * is at most
+     *
+     *   D SkipThreshold^2 / gamma^2
+     *
+     * (GetMaximumSkipError()). A SkipThreshold of 0 (default) skips nothing and gives the same values as
+     * SymmetricEigenAnalysisImageFilter -> KrcahSheetnessImageFilter.
+     *
+     * An optional occupancy image on a coarser grid gates whole blocks: voxels whose physical position falls into a
+     * block with the value 0 are set to 0 as well, e.g. blocks that contain only air.
+     *
+     * The skipped and gated voxels make the work per chunk uneven, the chunks are scheduled dynamically.
+     */
+    template<typename TInputImage, typename TOutputImage>
+    class ITK_EXPORT KrcahHessianSheetnessImageFilter
+            : public DynamicThreadedImageFilter<ImageToImageFilter<TInputImage, TOutputImage> > {
+    public:
+        typedef KrcahHessianSheetnessImageFilter Self;
+        typedef DynamicThreadedImageFilter<ImageToImageFilter<TInputImage, TOutputImage> > Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(KrcahHessianSheetnessImageFilter, ImageToImageFilter);
+        itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+        typedef TInputImage InputImageType;
+        typedef typename InputImageType::PixelType HessianPixelType;
+        typedef TOutputImage OutputImageType;
+        typedef typename OutputImageType::PixelType OutputPixelType;
+        typedef typename OutputImageType::RegionType OutputImageRegionType;
+
+        typedef FixedArray<double, HessianPixelType::Dimension> EigenValueArrayType;
+        typedef SymmetricEigenAnalysis<HessianPixelType, EigenValueArrayType> EigenAnalysisType;
+        typedef Functor::KrcahSheetness<EigenValueArrayType, double, OutputPixelType> FunctorType;
+
+        typedef Image<unsigned char, ImageDimension> OccupancyImageType;
+
+        itkSetMacro(Alpha, double);
+        itkGetConstMacro(Alpha, double);
+
+        itkSetMacro(Beta, double);
+        itkGetConstMacro(Beta, double);
+
+        itkSetMacro(Gamma, double);
+        itkGetConstMacro(Gamma, double);
+
+        // mean trace T of the Hessian over the image
+        itkSetMacro(TraceMean, double);
+        itkGetConstMacro(TraceMean, double);
+
+        itkSetMacro(UseFastExp, bool);
+        itkGetConstMacro(UseFastExp, bool);
+        itkBooleanMacro(UseFastExp);
+
+        // epsilon of the skip test ||H||_F < epsilon * |T|
+        itkSetMacro(SkipThreshold, double);
+        itkGetConstMacro(SkipThreshold, double);
+
+        // blocks to evaluate, ITK_NULLPTR (default) evaluates everywhere
+        itkSetConstObjectMacro(Occupancy, OccupancyImageType);
+        itkGetConstObjectMacro(Occupancy, OccupancyImageType);
+
+        // voxels of the last update set to 0 by the occupancy image
+        itkGetConstMacro(NumberOfGatedPixels, SizeValueType);
+
+        // voxels of the last update set to 0 by the skip test
+        itkGetConstMacro(NumberOfSkippedPixels, SizeValueType);
+
+        // voxels of the last update
+        itkGetConstMacro(NumberOfPixels, SizeValueType);
+
+        double GetSkippedFraction() const {
+            return m_NumberOfPixels > 0 ? static_cast<double>(m_NumberOfSkippedPixels) / m_NumberOfPixels : 0.0;
+        }
+
+        // upper bound of |sheetness| of any skipped voxel, the largest error the skip test can introduce
+        double GetMaximumSkipError() const;
+
+    protected:
+        KrcahHessianSheetnessImageFilter();
+
+        virtual ~KrcahHessianSheetnessImageFilter() {
+        }
+
+        void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+        void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+
+        void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        KrcahHessianSheetnessImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        double m_Alpha;
+        double m_Beta;
+        double m_Gamma;
+        double m_TraceMean;
+        bool m_UseFastExp;
+        double m_SkipThreshold;
+        typename OccupancyImageType::ConstPointer m_Occupancy;
+        SizeValueType m_NumberOfSkippedPixels;
+        SizeValueType m_NumberOfGatedPixels;
+        SizeValueType m_NumberOfPixels;
+        std::vector<SizeValueType> m_SkippedPerThread;
+        std::vector<SizeValueType> m_GatedPerThread;
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "KrcahHessianSheetnessImageFilter.hxx"
+
+#endif
+
+#endif //__KrcahHessianSheetnessImageFilter_h_
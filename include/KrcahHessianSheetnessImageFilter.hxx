@@ -0,0 +1,176 @@
+#ifndef __KrcahHessianSheetnessImageFilter_hxx_
+#define __KrcahHessianSheetnessImageFilter_hxx_
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkContinuousIndex.h"
+#include "itkMath.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+    template<typename TInputImage, typename TOutputImage>
+    KrcahHessianSheetnessImageFilter<TInputImage, TOutputImage>
+    ::KrcahHessianSheetnessImageFilter()
+    // suggested values by Krcah el. al.
+            : m_Alpha(0.5), m_Beta(0.5), m_Gamma(0.25), m_TraceMean(1.0), m_UseFastExp(false), m_SkipThreshold(0.0)
+            , m_NumberOfSkippedPixels(0), m_NumberOfGatedPixels(0), m_NumberOfPixels(0) {
+        this->SetNumberOfRequiredInputs(1);
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    double KrcahHessianSheetnessImageFilter<TInputImage, TOutputImage>
+    ::GetMaximumSkipError() const {
+        if (m_SkipThreshold <= 0) {
+            return 0.0;
+        }
+        return std::min(1.0, ImageDimension * m_SkipThreshold * m_SkipThreshold / (m_Gamma * m_Gamma));
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void KrcahHessianSheetnessImageFilter<TInputImage, TOutputImage>
+    ::BeforeThreadedGenerateData() {
+        // the chunks get the thread ids 1 to NumberOfThreads, see DynamicThreadedImageFilter
+        m_SkippedPerThread.assign(this->GetNumberOfThreads() + 1, 0);
+        m_GatedPerThread.assign(this->GetNumberOfThreads() + 1, 0);
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void KrcahHessianSheetnessImageFilter<TInputImage, TOutputImage>
+    ::ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) {
+        const SizeValueType size0 = outputRegionForThread.GetSize(0);
+        if (size0 == 0) {
+            return;
+        }
+
+        const InputImageType *input = this->GetInput();
+        OutputImageType *output = this->GetOutput();
+
+        FunctorType functor;
+        functor.SetAlpha(m_Alpha);
+        functor.SetBeta(m_Beta);
+        functor.SetGamma(m_Gamma);
+        functor.SetUseFastExp(m_UseFastExp);
+
+        EigenAnalysisType eigenAnalysis;
+        eigenAnalysis.SetDimension(ImageDimension);
+
+        // ||H||_F^2 < (epsilon T)^2, off-diagonal elements count twice
+        const double threshold = m_SkipThreshold * m_TraceMean;
+        const double threshold2 = threshold * threshold;
+        const double trace = m_TraceMean;
+
+        // eigenvalues of the voxels of a line that are evaluated, and where they go
+        std::vector<EigenValueArrayType> eigenValues(size0);
+        std::vector<OutputPixelType> sheetness(size0);
+        std::vector<SizeValueType> positions(size0);
+        SizeValueType skipped = 0;
+        SizeValueType gated = 0;
+        typename OutputImageType::IndexType next;
+        typename OutputImageType::PointType point;
+        ContinuousIndex<double, ImageDimension> blockStart;
+        ContinuousIndex<double, ImageDimension> blockNext;
+        typename OccupancyImageType::IndexType block;
+        typename OccupancyImageType::RegionType occupancyRegion;
+        if (m_Occupancy) {
+            occupancyRegion = m_Occupancy->GetLargestPossibleRegion();
+        }
+
+        const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+        ProgressReporter progress(this, threadId, numberOfLinesToProcess);
+
+        ImageLinearConstIteratorWithIndex<OutputImageType> it(output, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const typename OutputImageType::IndexType index = it.GetIndex();
+            const HessianPixelType *line = input->GetBufferPointer() + input->ComputeOffset(index);
+            OutputPixelType *lineOut = output->GetBufferPointer() + output->ComputeOffset(index);
+
+            // the continuous block index is affine along the line, start and step are transformed once per line
+            if (m_Occupancy) {
+                input->TransformIndexToPhysicalPoint(index, point);
+                m_Occupancy->TransformPhysicalPointToContinuousIndex(point, blockStart);
+                next = index;
+                ++next[0];
+                input->TransformIndexToPhysicalPoint(next, point);
+                m_Occupancy->TransformPhysicalPointToContinuousIndex(point, blockNext);
+            }
+
+            SizeValueType n = 0;
+            for (SizeValueType i = 0; i < size0; ++i) {
+                if (m_Occupancy) {
+                    // rounded like TransformPhysicalPointToIndex, positions outside of the occupancy image are evaluated
+                    for (unsigned int d = 0; d < ImageDimension; ++d) {
+                        block[d] = Math::RoundHalfIntegerUp<IndexValueType>(
+                                blockStart[d] + i * (blockNext[d] - blockStart[d]));
+                    }
+                    if (occupancyRegion.IsInside(block) && !m_Occupancy->GetPixel(block)) {
+                        lineOut[i] = NumericTraits<OutputPixelType>::ZeroValue();
+                        ++gated;
+                        continue;
+                    }
+                }
+
+                const HessianPixelType &hessian = line[i];
+                if (threshold2 > 0) {
+                    double norm2 = 0;
+                    for (unsigned int r = 0; r < ImageDimension; ++r) {
+                        norm2 += hessian(r, r) * hessian(r, r);
+                        for (unsigned int c = r + 1; c < ImageDimension; ++c) {
+                            norm2 += 2 * hessian(r, c) * hessian(r, c);
+                        }
+                    }
+                    if (norm2 < threshold2) {
+                        lineOut[i] = NumericTraits<OutputPixelType>::ZeroValue();
+                        ++skipped;
+                        continue;
+                    }
+                }
+                eigenAnalysis.ComputeEigenValues(hessian, eigenValues[n]);
+                positions[n] = i;
+                ++n;
+            }
+
+            // the remaining voxels in one batch
+            functor.Evaluate(&eigenValues[0], &trace, 0, &sheetness[0], n);
+            for (SizeValueType j = 0; j < n; ++j) {
+                lineOut[positions[j]] = sheetness[j];
+            }
+            progress.CompletedPixel();
+        }
+        // one call per chunk
+        m_SkippedPerThread[threadId] += skipped;
+        m_GatedPerThread[threadId] += gated;
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void KrcahHessianSheetnessImageFilter<TInputImage, TOutputImage>
+    ::AfterThreadedGenerateData() {
+        m_NumberOfSkippedPixels = 0;
+        m_NumberOfGatedPixels = 0;
+        for (size_t t = 0; t < m_SkippedPerThread.size(); ++t) {
+            m_NumberOfSkippedPixels += m_SkippedPerThread[t];
+            m_NumberOfGatedPixels += m_GatedPerThread[t];
+        }
+        m_NumberOfPixels = this->GetOutput()->GetRequestedRegion().GetNumberOfPixels();
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void KrcahHessianSheetnessImageFilter<TInputImage, TOutputImage>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Alpha: " << m_Alpha << std::endl;
+        os << indent << "Beta: " << m_Beta << std::endl;
+        os << indent << "Gamma: " << m_Gamma << std::endl;
+        os << indent << "TraceMean: " << m_TraceMean << std::endl;
+        os << indent << "UseFastExp: " << m_UseFastExp << std::endl;
+        os << indent << "SkipThreshold: " << m_SkipThreshold << std::endl;
+        os << indent << "Occupancy: " << m_Occupancy.GetPointer() << std::endl;
+        os << indent << "NumberOfSkippedPixels: " << m_NumberOfSkippedPixels << std::endl;
+        os << indent << "NumberOfGatedPixels: " << m_NumberOfGatedPixels << std::endl;
+        os << indent << "NumberOfPixels: " << m_NumberOfPixels << std::endl;
+    }
+}
+
+#endif // __KrcahHessianSheetnessImageFilter_hxx_
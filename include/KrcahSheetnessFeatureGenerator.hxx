@@ -3,6 +3,10 @@
 
 //#include "KrcahSheetnessFeatureGenerator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
 namespace itk {
     template<typename TInput, typename TOutput>
     KrcahSheetnessFeatureGenerator<TInput, TOutput>
@@ -10,7 +14,21 @@ namespace itk {
     // suggested values by Krcah el. al.
             : m_GaussVariance(1) // =s
             , m_ScalingConstant(10) // =k
-            , m_Alpha(0.5), m_Beta(0.5), m_Gamma(0.25) 
+            , m_Alpha(0.5), m_Beta(0.5), m_Gamma(0.25)
+            , m_UseBoundaryFluxTraceMean(false)
+            , m_UseFastExp(false)
+            , m_UseScaleSpace(false)
+            , m_PyramidThreshold(0)
+            , m_PyramidMaximumShrinkFactor(4)
+            , m_LowContrastSkipThreshold(0)
+            , m_NumberOfLowContrastSkippedPixels(0)
+            , m_NumberOfEvaluatedPixels(0)
+            , m_LowContrastMaximumError(0)
+            , m_UseIntensityGate(false)
+            , m_IntensityGateThreshold(-200) // HU, below any bone density
+            , m_IntensityGateBlockSize(8)
+            , m_NumberOfIntensityGatedPixels(0)
+            , m_GenerateScaleIndexOutput(false)
             {
         m_SheetnessScales.push_back(0.75);
         m_SheetnessScales.push_back(1.00);
@@ -23,6 +41,42 @@ namespace itk {
     ::~KrcahSheetnessFeatureGenerator() {
     }
 
+    template<typename TInput, typename TOutput>
+    void KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::SetGenerateScaleIndexOutput(bool b) {
+        if (b == m_GenerateScaleIndexOutput) {
+            return;
+        }
+        m_GenerateScaleIndexOutput = b;
+        if (b) {
+            this->SetNumberOfRequiredOutputs(2);
+            this->SetNthOutput(1, this->MakeOutput(1));
+        } else {
+            this->SetNumberOfRequiredOutputs(1);
+            this->SetNumberOfIndexedOutputs(1);
+        }
+        this->Modified();
+    }
+
+    template<typename TInput, typename TOutput>
+    typename KrcahSheetnessFeatureGenerator<TInput, TOutput>::ScaleIndexImageType *
+    KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::GetScaleIndexOutput() {
+        if (!m_GenerateScaleIndexOutput) {
+            return ITK_NULLPTR;
+        }
+        return dynamic_cast<ScaleIndexImageType *>(this->ProcessObject::GetOutput(1));
+    }
+
+    template<typename TInput, typename TOutput>
+    DataObject::Pointer KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::MakeOutput(typename Superclass::DataObjectPointerArraySizeType idx) {
+        if (idx == 1) {
+            return ScaleIndexImageType::New().GetPointer();
+        }
+        return Superclass::MakeOutput(idx);
+    }
+
     template<typename TInput, typename TOutput>
     void KrcahSheetnessFeatureGenerator<TInput, TOutput>
     ::GenerateData() {
@@ -32,32 +86,374 @@ namespace itk {
         // assert we have a valid m_SheetnessScales
         assert(m_SheetnessScales.size() > 0);
 
-        // Calculate first sheetness
-        typename OutputImageType::Pointer sheetnessOutputImageTypePointer = generateSheetnessWithSigma(input, m_SheetnessScales.at(0));
+        m_NumberOfLowContrastSkippedPixels = 0;
+        m_NumberOfEvaluatedPixels = 0;
+        m_LowContrastMaximumError = 0;
+        m_NumberOfIntensityGatedPixels = 0;
+        m_Occupancy = m_UseIntensityGate ? generateOccupancy(input) : ITK_NULLPTR;
 
-        if (m_SheetnessScales.size() > 1) { // need for std::next()
-            for(SheetnessScalesType::iterator scalesIterator = std::next(m_SheetnessScales.begin()); scalesIterator != m_SheetnessScales.end(); ++scalesIterator) {
-                // Calculte the remaining (n-1) sheetnesses
-                typename OutputImageType::Pointer tempSheetnessOutputImageTypePointer = generateSheetnessWithSigma(input, (*scalesIterator));
+        // sheetness at every scale. All of them are kept until the reduction, the memory of K sheetness images
+        // instead of a chain of K-1 binary filters with one output allocation and pipeline update each.
+        typename MaximumAbsoluteValueFilterType::Pointer maximumAbsoluteValueFilter = MaximumAbsoluteValueFilterType::New();
+        if (m_UseScaleSpace) {
+            generateScaleSpaceSheetness(input, maximumAbsoluteValueFilter);
+        } else {
+            for (SheetnessScalesType::size_type i = 0; i < m_SheetnessScales.size(); ++i) {
+                maximumAbsoluteValueFilter->SetInput(i, generateSheetnessWithSigma(input, m_SheetnessScales[i]));
+            }
+        }
 
-                // Take abs max
-                typename MaximumAbsoluteValueFilterType::Pointer maximumAbsoluteValueFilter = MaximumAbsoluteValueFilterType::New();
-                maximumAbsoluteValueFilter->SetInput1(sheetnessOutputImageTypePointer);
-                maximumAbsoluteValueFilter->SetInput2(tempSheetnessOutputImageTypePointer);
-                maximumAbsoluteValueFilter->Update();
+        // take abs max of all scales at once, in the buffer of the first scale
+        maximumAbsoluteValueFilter->InPlaceOn();
+        maximumAbsoluteValueFilter->SetGenerateIndexOutput(m_GenerateScaleIndexOutput);
+        if (m_Telemetry) {
+            updateStage(maximumAbsoluteValueFilter.GetPointer(), "maximum absolute value");
+        }
+        maximumAbsoluteValueFilter->Update();
+        typename OutputImageType::Pointer sheetnessOutputImageTypePointer = maximumAbsoluteValueFilter->GetOutput();
 
-                // Save max and move on
-                sheetnessOutputImageTypePointer = maximumAbsoluteValueFilter->GetOutput();
-            }
+        // a skipped scale can lose the maximum to another scale of at most the same magnitude
+        if (m_SheetnessScales.size() > 1) {
+            m_LowContrastMaximumError = std::min(1.0, 2 * m_LowContrastMaximumError);
         }
+        if (m_Telemetry && m_LowContrastSkipThreshold > 0) {
+            m_Telemetry->SetMetric("low contrast skipped fraction", GetLowContrastSkippedFraction());
+            m_Telemetry->SetMetric("low contrast maximum error", m_LowContrastMaximumError);
+        }
+        if (m_Telemetry && m_UseIntensityGate) {
+            m_Telemetry->SetMetric("intensity gated fraction", GetIntensityGatedFraction());
+        }
+        m_Occupancy = ITK_NULLPTR;
 
         // copy output
         this->GetOutput()->Graft(sheetnessOutputImageTypePointer);
+        if (m_GenerateScaleIndexOutput) {
+            GetScaleIndexOutput()->Graft(maximumAbsoluteValueFilter->GetIndexOutput());
+        }
     }
 
     template<typename TInput, typename TOutput>
     typename TOutput::Pointer KrcahSheetnessFeatureGenerator<TInput, TOutput>
     ::generateSheetnessWithSigma(typename TInput::ConstPointer input, float sigma) {
+        const unsigned int shrinkFactor = pyramidShrinkFactor(input, sigma);
+        if (shrinkFactor > 1) {
+            std::ostringstream stagePrefix;
+            stagePrefix << "sigma " << sigma << ": ";
+
+            typename SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+            smoothingFilter->SetSigma(sigma);
+            smoothingFilter->SetInput(preprocess(input, stagePrefix.str()));
+            if (m_Telemetry) {
+                updateStage(smoothingFilter.GetPointer(), stagePrefix.str() + "smoothing");
+            }
+            smoothingFilter->Update();
+            return generateShrunkSheetness(smoothingFilter->GetOutput(), shrinkFactor, sigma, stagePrefix.str());
+        }
+
+        std::ostringstream stagePrefix;
+        stagePrefix << "sigma " << sigma << ": ";
+        double traceMean;
+        typename HessianImageType::Pointer hessian = generateHessianWithSigma(input, sigma, stagePrefix.str(),
+                                                                              traceMean);
+        return generateSheetness(hessian, traceMean, sigma, stagePrefix.str());
+    }
+
+    template<typename TInput, typename TOutput>
+    void KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateScaleSpaceSheetness(const InputImageType *input, MaximumAbsoluteValueFilterType *maximumAbsoluteValueFilter) {
+        for (SheetnessScalesType::size_type i = 1; i < m_SheetnessScales.size(); ++i) {
+            if (!(m_SheetnessScales[i] > m_SheetnessScales[i - 1])) {
+                itkExceptionMacro(<< "The scale space needs strictly ascending sheetness scales, got "
+                                  << m_SheetnessScales[i - 1] << " before " << m_SheetnessScales[i]);
+            }
+        }
+
+        // the preprocessing does not depend on the scale, it is done once
+        typename InternalImageType::Pointer smoothed = preprocess(input, "");
+
+        double previousSigma = 0;
+        for (SheetnessScalesType::size_type i = 0; i < m_SheetnessScales.size(); ++i) {
+            const double sigma = m_SheetnessScales[i];
+            std::ostringstream stagePrefix;
+            stagePrefix << "sigma " << sigma << ": ";
+
+            // G(sigma) = G(sqrt(sigma^2 - previousSigma^2)) * G(previousSigma). The recursive Gaussian costs the same
+            // for every sigma and is not truncated, unlike a FIR kernel of limited width
+            typename SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+            smoothingFilter->SetSigma(std::sqrt(sigma * sigma - previousSigma * previousSigma));
+            smoothingFilter->SetInput(smoothed);
+            if (m_Telemetry) {
+                updateStage(smoothingFilter.GetPointer(), stagePrefix.str() + "scale space smoothing");
+            }
+            smoothingFilter->Update();
+            smoothed = smoothingFilter->GetOutput();
+            previousSigma = sigma;
+
+            const unsigned int shrinkFactor = pyramidShrinkFactor(smoothed, sigma);
+            if (shrinkFactor > 1) {
+                maximumAbsoluteValueFilter->SetInput(i, generateShrunkSheetness(smoothed, shrinkFactor, sigma,
+                                                                                stagePrefix.str()));
+                continue;
+            }
+
+            // second derivatives of the smoothed image
+            typename DiscreteHessianFilterType::Pointer hessianFilter = DiscreteHessianFilterType::New();
+            hessianFilter->SetInput(smoothed);
+            if (m_Telemetry) {
+                updateStage(hessianFilter.GetPointer(), stagePrefix.str() + "hessian");
+            }
+
+            const double traceMean = computeTraceMean(hessianFilter->GetOutput(), stagePrefix.str());
+            maximumAbsoluteValueFilter->SetInput(i, generateSheetness(hessianFilter->GetOutput(), traceMean, sigma,
+                                                                      stagePrefix.str()));
+        }
+    }
+
+    template<typename TInput, typename TOutput>
+    unsigned int KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::pyramidShrinkFactor(const ImageBase<NDimension> *image, double sigma) const {
+        if (m_PyramidThreshold <= 0) {
+            return 1;
+        }
+
+        // sigma in voxels along the coarsest direction, the central differences need 3 voxels along every one
+        double maximumSpacing = 0;
+        SizeValueType minimumSize = NumericTraits<SizeValueType>::max();
+        for (unsigned int d = 0; d < NDimension; ++d) {
+            maximumSpacing = std::max(maximumSpacing, static_cast<double>(image->GetSpacing()[d]));
+            minimumSize = std::min(minimumSize, image->GetLargestPossibleRegion().GetSize(d));
+        }
+        const double sigmaInVoxels = sigma / maximumSpacing;
+
+        unsigned int shrinkFactor = 1;
+        while (2 * shrinkFactor <= m_PyramidMaximumShrinkFactor
+               && sigmaInVoxels >= m_PyramidThreshold * shrinkFactor
+               && minimumSize / (2 * shrinkFactor) >= 3) {
+            shrinkFactor *= 2;
+        }
+        return shrinkFactor;
+    }
+
+    template<typename TInput, typename TOutput>
+    typename TOutput::Pointer KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateShrunkSheetness(const InternalImageType *smoothed, unsigned int shrinkFactor, double sigma,
+                              const std::string &stagePrefix) {
+        // subsample, the image is already band limited by the Gaussian of the scale
+        typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+        shrinkFilter->SetShrinkFactors(shrinkFactor);
+        shrinkFilter->SetInput(smoothed);
+        if (m_Telemetry) {
+            updateStage(shrinkFilter.GetPointer(), stagePrefix + "shrink");
+        }
+
+        // second derivatives on the coarse grid
+        typename DiscreteHessianFilterType::Pointer hessianFilter = DiscreteHessianFilterType::New();
+        hessianFilter->SetInput(shrinkFilter->GetOutput());
+        if (m_Telemetry) {
+            updateStage(hessianFilter.GetPointer(), stagePrefix + "hessian");
+        }
+
+        const double traceMean = computeTraceMean(hessianFilter->GetOutput(), stagePrefix);
+        typename OutputImageType::Pointer sheetness = generateSheetness(hessianFilter->GetOutput(), traceMean, sigma,
+                                                                        stagePrefix);
+
+        // back to the input grid. The outermost input voxels lie up to half a coarse voxel outside the centers of
+        // the coarse grid, they take the nearest coarse value.
+        typename ResampleFilterType::Pointer resampleFilter = ResampleFilterType::New();
+        resampleFilter->SetInput(sheetness);
+        resampleFilter->SetInterpolator(InterpolatorType::New());
+        resampleFilter->SetExtrapolator(ExtrapolatorType::New());
+        resampleFilter->SetSize(smoothed->GetLargestPossibleRegion().GetSize());
+        resampleFilter->SetOutputStartIndex(smoothed->GetLargestPossibleRegion().GetIndex());
+        resampleFilter->SetOutputOrigin(smoothed->GetOrigin());
+        resampleFilter->SetOutputSpacing(smoothed->GetSpacing());
+        resampleFilter->SetOutputDirection(smoothed->GetDirection());
+        if (m_Telemetry) {
+            updateStage(resampleFilter.GetPointer(), stagePrefix + "upsampling");
+        }
+        resampleFilter->Update();
+        return resampleFilter->GetOutput();
+    }
+
+    template<typename TInput, typename TOutput>
+    typename KrcahSheetnessFeatureGenerator<TInput, TOutput>::OccupancyImageType::Pointer
+    KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateOccupancy(const InputImageType *input) const {
+        const typename InputImageType::RegionType region = input->GetBufferedRegion();
+        const typename InputImageType::SpacingType spacing = input->GetSpacing();
+        const double largestSigma = *std::max_element(m_SheetnessScales.begin(), m_SheetnessScales.end());
+        const IndexValueType blockSize = m_IntensityGateBlockSize;
+
+        // one voxel per block, centered on the block
+        typename OccupancyImageType::SizeType size;
+        typename OccupancyImageType::SpacingType blockSpacing;
+        ContinuousIndex<double, NDimension> center;
+        IndexValueType reach[NDimension]; // in blocks
+        for (unsigned int d = 0; d < NDimension; ++d) {
+            size[d] = (region.GetSize(d) + blockSize - 1) / blockSize;
+            blockSpacing[d] = spacing[d] * blockSize;
+            center[d] = region.GetIndex(d) + 0.5 * (blockSize - 1);
+            const double voxels = 3 * (largestSigma + std::sqrt(m_GaussVariance)) / spacing[d];
+            reach[d] = static_cast<IndexValueType>(std::ceil(voxels / blockSize));
+        }
+        typename OccupancyImageType::PointType origin;
+        input->TransformContinuousIndexToPhysicalPoint(center, origin);
+
+        typename OccupancyImageType::Pointer dense = OccupancyImageType::New();
+        dense->SetRegions(size);
+        dense->SetSpacing(blockSpacing);
+        dense->SetOrigin(origin);
+        dense->SetDirection(input->GetDirection());
+        dense->Allocate();
+        dense->FillBuffer(0);
+
+        // blocks with a voxel at or above the threshold
+        typename OccupancyImageType::IndexType block;
+        ImageRegionConstIteratorWithIndex<InputImageType> it(input, region);
+        for (; !it.IsAtEnd(); ++it) {
+            if (static_cast<double>(it.Get()) >= m_IntensityGateThreshold) {
+                for (unsigned int d = 0; d < NDimension; ++d) {
+                    block[d] = (it.GetIndex()[d] - region.GetIndex(d)) / blockSize;
+                }
+                dense->SetPixel(block, 1);
+            }
+        }
+
+        // and every block within reach of them
+        typename OccupancyImageType::Pointer occupancy = OccupancyImageType::New();
+        occupancy->CopyInformation(dense);
+        occupancy->SetRegions(dense->GetLargestPossibleRegion());
+        occupancy->Allocate();
+        occupancy->FillBuffer(0);
+        ImageRegionConstIteratorWithIndex<OccupancyImageType> bt(dense, dense->GetLargestPossibleRegion());
+        for (; !bt.IsAtEnd(); ++bt) {
+            if (!bt.Get()) {
+                continue;
+            }
+            typename OccupancyImageType::RegionType neighbors;
+            for (unsigned int d = 0; d < NDimension; ++d) {
+                neighbors.SetIndex(d, bt.GetIndex()[d] - reach[d]);
+                neighbors.SetSize(d, 2 * reach[d] + 1);
+            }
+            neighbors.Crop(occupancy->GetLargestPossibleRegion());
+            ImageRegionIterator<OccupancyImageType> nt(occupancy, neighbors);
+            for (; !nt.IsAtEnd(); ++nt) {
+                nt.Set(1);
+            }
+        }
+        return occupancy;
+    }
+
+    template<typename TInput, typename TOutput>
+    typename TOutput::Pointer KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateSheetness(const HessianImageType *hessian, double traceMean, double sigma, const std::string &stagePrefix) {
+        if (m_LowContrastSkipThreshold <= 0 && !m_Occupancy) {
+            return generateSheetness(generateEigenValues(hessian, stagePrefix), traceMean, sigma);
+        }
+
+        // eigenvalues and sheetness in one pass, low contrast and gated voxels skip both
+        typename HessianSheetnessFilterType::Pointer sheetnessFilter = HessianSheetnessFilterType::New();
+        sheetnessFilter->SetInput(hessian);
+        sheetnessFilter->SetTraceMean(traceMean);
+        sheetnessFilter->SetAlpha(m_Alpha);
+        sheetnessFilter->SetBeta(m_Beta);
+        sheetnessFilter->SetGamma(m_Gamma);
+        sheetnessFilter->SetUseFastExp(m_UseFastExp);
+        sheetnessFilter->SetSkipThreshold(m_LowContrastSkipThreshold);
+        sheetnessFilter->SetOccupancy(m_Occupancy);
+        if (m_Telemetry) {
+            updateStage(sheetnessFilter.GetPointer(), stagePrefix + "eigen analysis and sheetness");
+        }
+        sheetnessFilter->Update();
+
+        m_NumberOfLowContrastSkippedPixels += sheetnessFilter->GetNumberOfSkippedPixels();
+        m_NumberOfEvaluatedPixels += sheetnessFilter->GetNumberOfPixels();
+        m_NumberOfIntensityGatedPixels += sheetnessFilter->GetNumberOfGatedPixels();
+        if (sheetnessFilter->GetNumberOfSkippedPixels() > 0) {
+            m_LowContrastMaximumError = std::max(m_LowContrastMaximumError, sheetnessFilter->GetMaximumSkipError());
+        }
+        return sheetnessFilter->GetOutput();
+    }
+
+    template<typename TInput, typename TOutput>
+    typename TOutput::Pointer KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateSheetness(const EigenValueImageType *eigenValues, double traceMean, double sigma) {
+        /******
+        * Sheetness
+        ******/
+        typename SheetnessFilterType::Pointer m_SheetnessFilter = SheetnessFilterType::New();
+        m_SheetnessFilter->SetInput(eigenValues);
+        m_SheetnessFilter->SetConstant(traceMean);
+        m_SheetnessFilter->SetAlpha(m_Alpha);
+        m_SheetnessFilter->SetBeta(m_Beta);
+        m_SheetnessFilter->SetGamma(m_Gamma);
+        m_SheetnessFilter->SetUseFastExp(m_UseFastExp);
+
+        // return
+        if (m_Telemetry) {
+            std::ostringstream stage;
+            stage << "sigma " << sigma << ": sheetness";
+            updateStage(m_SheetnessFilter.GetPointer(), stage.str());
+        }
+        m_SheetnessFilter->Update();
+        return m_SheetnessFilter->GetOutput();
+    }
+
+    template<typename TInput, typename TOutput>
+    typename KrcahSheetnessFeatureGenerator<TInput, TOutput>::EigenValueImageType::Pointer
+    KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::GenerateEigenValuesWithSigma(const InputImageType *input, double sigma, double &traceMean) {
+        std::ostringstream stagePrefix;
+        stagePrefix << "sigma " << sigma << ": ";
+        typename HessianImageType::Pointer hessian = generateHessianWithSigma(input, sigma, stagePrefix.str(),
+                                                                              traceMean);
+        return generateEigenValues(hessian, stagePrefix.str());
+    }
+
+    template<typename TInput, typename TOutput>
+    typename KrcahSheetnessFeatureGenerator<TInput, TOutput>::HessianImageType::Pointer
+    KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateHessianWithSigma(const InputImageType *input, double sigma, const std::string &stagePrefix,
+                               double &traceMean) {
+        typename InternalImageType::Pointer preprocessed = preprocess(input, stagePrefix);
+
+        /******
+        * sheetness prerequisites
+        ******/
+        // hessian
+        typename HessianFilterType::Pointer m_HessianFilter = HessianFilterType::New();
+        m_HessianFilter->SetSigma(sigma);
+        m_HessianFilter->SetInput(preprocessed);
+        if (m_Telemetry) {
+            updateStage(m_HessianFilter.GetPointer(), stagePrefix + "hessian");
+        }
+
+        if (m_UseBoundaryFluxTraceMean) {
+            // only reads the boundary slabs of the hessian input
+            typename TraceMeanCalculatorType::Pointer traceMeanCalculator = TraceMeanCalculatorType::New();
+            traceMeanCalculator->SetImage(preprocessed);
+            traceMeanCalculator->SetSigma(sigma);
+            const std::string stage = stagePrefix + "trace mean";
+            if (m_Telemetry) {
+                m_Telemetry->StartStage(stage);
+            }
+            traceMeanCalculator->Compute();
+            if (m_Telemetry) {
+                m_Telemetry->StopStage(stage, traceMeanCalculator->GetNumberOfVisitedPixels(), 0, 1);
+            }
+            traceMean = traceMeanCalculator->GetMean();
+        } else {
+            traceMean = computeTraceMean(m_HessianFilter->GetOutput(), stagePrefix);
+        }
+
+        m_HessianFilter->Update();
+        return m_HessianFilter->GetOutput();
+    }
+
+    template<typename TInput, typename TOutput>
+    typename KrcahSheetnessFeatureGenerator<TInput, TOutput>::InternalImageType::Pointer
+    KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::preprocess(const InputImageType *input, const std::string &stagePrefix) {
         /******
         * Input preprocessing
         ******/
@@ -84,42 +480,73 @@ namespace itk {
         m_AddFilter->SetInput1(castFilter->GetOutput());
         m_AddFilter->SetInput2(m_MultiplyFilter->GetOutput());
 
-        /******
-        * sheetness prerequisites
-        ******/
-        // hessian
-        typename HessianFilterType::Pointer m_HessianFilter = HessianFilterType::New();
-        m_HessianFilter->SetSigma(sigma);
-        m_HessianFilter->SetInput(m_AddFilter->GetOutput());
+        if (m_Telemetry) {
+            const std::string stage = stagePrefix + "preprocessing";
+            m_Telemetry->StartStage(stage);
+            m_AddFilter->Update();
+            m_Telemetry->StopStage(stage, m_AddFilter->GetOutput()->GetBufferedRegion().GetNumberOfPixels(),
+                                   PerformanceTelemetry::GetImageBufferSize(castFilter->GetOutput())
+                                   + PerformanceTelemetry::GetImageBufferSize(m_DiffusionFilter->GetOutput())
+                                   + PerformanceTelemetry::GetImageBufferSize(m_SubstractFilter->GetOutput())
+                                   + PerformanceTelemetry::GetImageBufferSize(m_MultiplyFilter->GetOutput())
+                                   + PerformanceTelemetry::GetImageBufferSize(m_AddFilter->GetOutput()),
+                                   m_AddFilter->GetNumberOfThreads());
+        }
 
-        // eigen analysis
-        typename EigenAnalysisFilterType::Pointer m_EigenAnalysisFilter = EigenAnalysisFilterType::New();
-        m_EigenAnalysisFilter->SetDimension(NDimension);
-        m_EigenAnalysisFilter->SetInput(m_HessianFilter->GetOutput());
+        // the mini pipeline ends here, the intermediates are released with the filters
+        m_AddFilter->Update();
+        return m_AddFilter->GetOutput();
+    }
 
+    template<typename TInput, typename TOutput>
+    double KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::computeTraceMean(const HessianImageType *hessian, const std::string &stagePrefix) {
         // calculate trace
         typename TraceFilterType::Pointer m_TraceFilter = TraceFilterType::New();
-        m_TraceFilter->SetImageDimension(NDimension);
-        m_TraceFilter->SetInput(m_HessianFilter->GetOutput());
+        m_TraceFilter->SetInput(hessian);
+        if (m_Telemetry) {
+            updateStage(m_TraceFilter.GetPointer(), stagePrefix + "trace");
+        }
 
         // calculate average
         typename StatisticsFilterType::Pointer m_StatisticsFilter = StatisticsFilterType::New();
         m_StatisticsFilter->SetInput(m_TraceFilter->GetOutput());
+        if (m_Telemetry) {
+            // the output is the input passed through, nothing is allocated
+            const std::string stage = stagePrefix + "trace mean";
+            m_Telemetry->StartStage(stage);
+            m_StatisticsFilter->Update();
+            m_Telemetry->StopStage(stage, m_TraceFilter->GetOutput()->GetBufferedRegion().GetNumberOfPixels(), 0,
+                                   m_StatisticsFilter->GetNumberOfThreads());
+        }
         m_StatisticsFilter->Update(); // needed! ->GetMean() will not trigger an update!
+        return m_StatisticsFilter->GetMean();
+    }
 
-        /******
-        * Sheetness
-        ******/
-        typename SheetnessFilterType::Pointer m_SheetnessFilter = SheetnessFilterType::New();
-        m_SheetnessFilter->SetInput(m_EigenAnalysisFilter->GetOutput());
-        m_SheetnessFilter->SetConstant(m_StatisticsFilter->GetMean());
-        m_SheetnessFilter->SetAlpha(m_Alpha);
-        m_SheetnessFilter->SetBeta(m_Beta);
-        m_SheetnessFilter->SetGamma(m_Gamma);
+    template<typename TInput, typename TOutput>
+    typename KrcahSheetnessFeatureGenerator<TInput, TOutput>::EigenValueImageType::Pointer
+    KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::generateEigenValues(const HessianImageType *hessian, const std::string &stagePrefix) {
+        // eigen analysis
+        typename EigenAnalysisFilterType::Pointer m_EigenAnalysisFilter = EigenAnalysisFilterType::New();
+        m_EigenAnalysisFilter->SetDimension(NDimension);
+        m_EigenAnalysisFilter->SetInput(hessian);
+        if (m_Telemetry) {
+            updateStage(m_EigenAnalysisFilter.GetPointer(), stagePrefix + "eigen analysis");
+        }
+        m_EigenAnalysisFilter->Update();
+        return m_EigenAnalysisFilter->GetOutput();
+    }
 
-        // return
-        m_SheetnessFilter->Update();
-        return m_SheetnessFilter->GetOutput();
+    template<typename TInput, typename TOutput>
+    template<typename TFilter>
+    void KrcahSheetnessFeatureGenerator<TInput, TOutput>
+    ::updateStage(TFilter *filter, const std::string &stage) {
+        m_Telemetry->StartStage(stage);
+        filter->Update();
+        m_Telemetry->StopStage(stage, filter->GetOutput()->GetBufferedRegion().GetNumberOfPixels(),
+                               PerformanceTelemetry::GetImageBufferSize(filter->GetOutput()),
+                               filter->GetNumberOfThreads());
     }
 }
 
@@ -3,61 +3,190 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "vnl/vnl_math.h"
+#include "FastExp.h"
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 
 namespace itk {
     namespace Functor {
-        template<class TInputPixel, class TTracePixel, class TOutputPixel>
+        /*
+         * Ratios of the Krcah measure from the eigenvalues of one voxel, specialized on the number of eigenvalues.
+         * The eigenvalues are sorted by their absolute value with a compare-exchange network on selects. Compute()
+         * returns false if the denominators are close to zero, the ratios are finite but meaningless then.
+         */
+        template<unsigned int VDimension>
+        struct KrcahSheetnessRatios;
+
+        struct KrcahSheetnessRatiosBase {
+            // sort (l1, l2) ascending and carry (a1, a2) along, without a branch
+            static inline void compareExchange(double &l1, double &l2, double &a1, double &a2) {
+                const bool swap = l1 > l2;
+                const double lowL = swap ? l2 : l1;
+                const double highL = swap ? l1 : l2;
+                const double lowA = swap ? a2 : a1;
+                const double highA = swap ? a1 : a2;
+                l1 = lowL;
+                l2 = highL;
+                a1 = lowA;
+                a2 = highA;
+            }
+        };
+
+        // bright sheets have |l1| <= |l2| << |l3|: Rsheet = l2 / l3, Rtube = l1 / (l2 l3), Rnoise = (l1 + l2 + l3) / T
+        template<>
+        struct KrcahSheetnessRatios<3> : public KrcahSheetnessRatiosBase {
+            template<class TInputPixel>
+            static inline bool Compute(const TInputPixel &A, double T, double &largest,
+                                       double &Rsheet, double &Rtube, double &Rnoise) {
+                double a1 = static_cast<double>( A[0] );
+                double a2 = static_cast<double>( A[1] );
+                double a3 = static_cast<double>( A[2] );
+                double l1 = vnl_math_abs(a1);
+                double l2 = vnl_math_abs(a2);
+                double l3 = vnl_math_abs(a3);
+
+                // l1 <= l2 <= l3
+                compareExchange(l1, l2, a1, a2);
+                compareExchange(l1, l3, a1, a3);
+                compareExchange(l2, l3, a2, a3);
+
+                // the denominators are kept away from zero, l2 <= l3 so the test of l2 covers both
+                const bool valid = !(l2 < vnl_math::eps);
+                const double s2 = valid ? l2 : 1.0;
+                const double s3 = valid ? l3 : 1.0;
+
+                //const double T = l1 + l2 + l3; // http://en.wikipedia.org/wiki/Trace_%28linear_algebra%29#Eigenvalue_relationships
+                Rsheet = s2 / s3;
+                Rnoise = (l1 + l2 + l3) / T;
+                Rtube = l1 / (s2 * s3);
+                largest = a3;
+                return valid;
+            }
+        };
+
+        // a slice through a sheet shows a line, |l1| << |l2|: Rsheet = l1 / l2, Rnoise = (l1 + l2) / T, no tube term
+        template<>
+        struct KrcahSheetnessRatios<2> : public KrcahSheetnessRatiosBase {
+            template<class TInputPixel>
+            static inline bool Compute(const TInputPixel &A, double T, double &largest,
+                                       double &Rsheet, double &Rtube, double &Rnoise) {
+                double a1 = static_cast<double>( A[0] );
+                double a2 = static_cast<double>( A[1] );
+                double l1 = vnl_math_abs(a1);
+                double l2 = vnl_math_abs(a2);
+
+                // l1 <= l2
+                compareExchange(l1, l2, a1, a2);
+
+                const bool valid = !(l2 < vnl_math::eps);
+                const double s2 = valid ? l2 : 1.0;
+
+                Rsheet = l1 / s2;
+                Rnoise = (l1 + l2) / T;
+                Rtube = 0.0;
+                largest = a2;
+                return valid;
+            }
+        };
+
+        /*
+         * Krcah sheetness of VDimension eigenvalues, by default the length of the eigenvalue array. The 3D measure
+         * is the one of Krcah et al., the 2D one detects bright lines, e.g. for slice-wise previews.
+         *
+         * The 2D measure has no tube term: with two eigenvalues Rtube = l1 / (l2 l3) does not exist, Beta has no
+         * effect and the factor exp(-Rtube^2 / Beta^2) is left out. A slice cuts a sheet and a tube along its axis
+         * both as a line, so in 2D the measure cannot tell them apart, where the 3D measure suppresses the tube.
+         */
+        template<class TInputPixel, class TTracePixel, class TOutputPixel,
+                unsigned int VDimension = TInputPixel::Dimension>
         class KrcahSheetness {
         public:
+            typedef KrcahSheetnessRatios<VDimension> RatiosType;
+
             KrcahSheetness() {
                 // suggested values by Krcah el. al.
                 m_Alpha = 0.5;
                 m_Beta = 0.5;
                 m_Gamma = 0.25;
+                m_UseFastExp = false;
             }
 
             inline TOutputPixel operator()(const TInputPixel &A, const TTracePixel T) {
                 double sheetness = 0.0;
-                double a1 = static_cast<double>( A[0] );
-                double a2 = static_cast<double>( A[1] );
-                double a3 = static_cast<double>( A[2] );
-                double l1 = vnl_math_abs(a1);
-                double l2 = vnl_math_abs(a2);
-                double l3 = vnl_math_abs(a3);
+                double largest, Rsheet, Rtube, Rnoise;
 
-                // Sort the values by their absolute value.
-                // At the end of the sorting we should have
-                // l1 <= l2 <= l3
-                if (l1 > l2) {
-                    std::swap(l1, l2);
-                    std::swap(a1, a2);
-                }
-                if (l1 > l3) {
-                    std::swap(l1, l3);
-                    std::swap(a1, a3);
+                // Avoid divisions by zero (or close to zero)
+                if (!RatiosType::Compute(A, static_cast<double>( T ), largest, Rsheet, Rtube, Rnoise)) {
+                    return static_cast<TOutputPixel>( sheetness );
                 }
-                if (l2 > l3) {
-                    std::swap(l2, l3);
-                    std::swap(a2, a3);
+
+                sheetness = (-vnl_math_sgn(largest));
+                sheetness *= exponential(-(Rsheet * Rsheet) / (m_Alpha * m_Alpha));
+                if (VDimension > 2) {
+                    sheetness *= exponential(-(Rtube * Rtube) / (m_Beta * m_Beta));
                 }
+                sheetness *= (1.0 - exponential(-(Rnoise * Rnoise) / (m_Gamma * m_Gamma)));
 
-                // Avoid divisions by zero (or close to zero)
-                if (static_cast<double>( l3 ) < vnl_math::eps || static_cast<double>( l2 ) < vnl_math::eps) {
-                    return static_cast<TOutputPixel>( sheetness );
+                return static_cast<TOutputPixel>( sheetness );
+            }
+
+            // Batch evaluation of n voxels, output[i] = (*this)(A[i], T[i * traceStride]) with the same rounding.
+            // A traceStride of 0 uses the single value *T for all voxels.
+            //
+            // With FastExp, blocks of BatchSize voxels are processed in structure-of-arrays form. The ratios come
+            // from the branch-free sort by absolute value, the early return for small eigenvalues becomes a sign of
+            // 0 that is selected at the end, and the exponentials and the product run in one straight-line loop, so
+            // both loops vectorize. std::exp has no vector form, with it the voxels are evaluated one by one, where
+            // the early return saves the exponentials of the masked voxels.
+            static const unsigned int BatchSize = 64;
+
+            void Evaluate(const TInputPixel *A, const TTracePixel *T, std::ptrdiff_t traceStride,
+                          TOutputPixel *output, size_t n) const {
+                if (!m_UseFastExp) {
+                    KrcahSheetness functor(*this);
+                    for (size_t i = 0; i < n; ++i) {
+                        output[i] = functor(A[i], T[i * traceStride]);
+                    }
+                    return;
                 }
 
-                //const double T = l1 + l2 + l3; // http://en.wikipedia.org/wiki/Trace_%28linear_algebra%29#Eigenvalue_relationships
-                const double Rsheet = l2 / l3;
-                const double Rnoise = (l1 + l2 + l3) / T;
-                const double Rtube = l1 / (l2 * l3);
+                double sign[BatchSize];
+                double sheet[BatchSize];
+                double tube[BatchSize];
+                double noise[BatchSize];
 
-                sheetness = (-vnl_math_sgn(a3));
-                sheetness *= vcl_exp(-(Rsheet * Rsheet) / (m_Alpha * m_Alpha));
-                sheetness *= vcl_exp(-(Rtube * Rtube) / (m_Beta * m_Beta));
-                sheetness *= (1.0 - vcl_exp(-(Rnoise * Rnoise) / (m_Gamma * m_Gamma)));
+                const double alpha2 = m_Alpha * m_Alpha;
+                const double beta2 = m_Beta * m_Beta;
+                const double gamma2 = m_Gamma * m_Gamma;
 
-                return static_cast<TOutputPixel>( sheetness );
+                for (size_t start = 0; start < n; start += BatchSize) {
+                    const size_t m = std::min<size_t>(BatchSize, n - start);
+
+                    for (size_t i = 0; i < m; ++i) {
+                        // masked instead of returning early: a sign of 0 and arguments of 0, so the product is 0
+                        double largest, Rsheet, Rtube, Rnoise;
+                        const bool valid = RatiosType::Compute(A[start + i],
+                                                               static_cast<double>( T[(start + i) * traceStride] ),
+                                                               largest, Rsheet, Rtube, Rnoise);
+
+                        // |largest| >= eps for a valid voxel, so its sign is never 0
+                        sign[i] = valid ? -std::copysign(1.0, largest) : 0.0;
+                        sheet[i] = valid ? -(Rsheet * Rsheet) / alpha2 : 0.0;
+                        tube[i] = valid ? -(Rtube * Rtube) / beta2 : 0.0;
+                        noise[i] = valid ? -(Rnoise * Rnoise) / gamma2 : 0.0;
+                    }
+
+                    for (size_t i = 0; i < m; ++i) {
+                        double sheetness = sign[i];
+                        sheetness *= FastExp(sheet[i]);
+                        if (VDimension > 2) {
+                            sheetness *= FastExp(tube[i]);
+                        }
+                        sheetness *= (1.0 - FastExp(noise[i]));
+                        output[start + i] = static_cast<TOutputPixel>( sheetness );
+                    }
+                }
             }
 
             void SetAlpha(double value) {
@@ -72,10 +201,24 @@ namespace itk {
                 this->m_Gamma = value;
             }
 
+            // evaluate the exponentials with FastExp, relative error below FastExpMaximumRelativeError
+            void SetUseFastExp(bool value) {
+                this->m_UseFastExp = value;
+            }
+
+            bool GetUseFastExp() const {
+                return this->m_UseFastExp;
+            }
+
         private:
+            inline double exponential(double x) const {
+                return m_UseFastExp ? FastExp(x) : vcl_exp(x);
+            }
+
             double m_Alpha;
             double m_Beta;
             double m_Gamma;
+            bool m_UseFastExp;
         };
     }
 }
@@ -3,28 +3,38 @@
 
 #include "itkBinaryFunctorImageFilter.h"
 #include "KrcahSheetnessFunctor.h"
+#include "DynamicThreadedImageFilter.h"
 
 namespace itk {
+    /*
+     * Krcah sheetness of an eigenvalue image, T is a second image or a constant set with SetConstant(). On 2D
+     * images the functor drops the tube term and SetBeta() has no effect, see Functor::KrcahSheetness.
+     */
     template<typename TInputImage, typename TConstant, typename TOutputImage>
     class KrcahSheetnessImageFilter :
-            public BinaryFunctorImageFilter<TInputImage, Image<TConstant, TInputImage::ImageDimension>, TOutputImage,
-                    Functor::KrcahSheetness<typename TInputImage::PixelType, TConstant, typename TOutputImage::PixelType> > {
+            public DynamicThreadedImageFilter<BinaryFunctorImageFilter<TInputImage, Image<TConstant, TInputImage::ImageDimension>, TOutputImage,
+                    Functor::KrcahSheetness<typename TInputImage::PixelType, TConstant, typename TOutputImage::PixelType> > > {
     public:
         // itk requirements
         typedef KrcahSheetnessImageFilter Self;
-        typedef BinaryFunctorImageFilter<TInputImage, Image<TConstant, TInputImage::ImageDimension>, TOutputImage,
-                Functor::KrcahSheetness<typename TInputImage::PixelType, TConstant, typename TOutputImage::PixelType> > Superclass;
+        typedef DynamicThreadedImageFilter<BinaryFunctorImageFilter<TInputImage, Image<TConstant, TInputImage::ImageDimension>, TOutputImage,
+                Functor::KrcahSheetness<typename TInputImage::PixelType, TConstant, typename TOutputImage::PixelType> > > Superclass;
         typedef SmartPointer<Self> Pointer;
         typedef SmartPointer<const Self> ConstPointer;
 
         itkNewMacro(Self); // create the smart pointers and register with ITKs object factory
         itkTypeMacro(KrcahSheetnessImageFilter, BinaryFunctorImageFilter); // type information for runtime evaluation
 
+        typedef typename Superclass::Input1ImageType Input1ImageType;
+        typedef typename Superclass::Input2ImageType Input2ImageType;
+        typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
         // member functions
         void SetAlpha(double value) {
             this->GetFunctor().SetAlpha(value);
         }
 
+        // weight of the tube term, 3D only
         void SetBeta(double value) {
             this->GetFunctor().SetBeta(value);
         }
@@ -33,6 +43,10 @@ namespace itk {
             this->GetFunctor().SetGamma(value);
         }
 
+        void SetUseFastExp(bool value) {
+            this->GetFunctor().SetUseFastExp(value);
+        }
+
     protected:
         KrcahSheetnessImageFilter() {
         };
@@ -40,10 +54,19 @@ namespace itk {
         virtual ~KrcahSheetnessImageFilter() {
         };
 
+        // evaluates the functor on whole scanlines with its batch API instead of pixel by pixel
+        void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+
     private:
         KrcahSheetnessImageFilter(const Self &); //purposely not implemented
         void operator=(const Self &);   //purposely not implemented
     };
 }
 
-#endif //__KrcahSheetnessImageFilter_h_
\ No newline at end of file
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "KrcahSheetnessImageFilter.hxx"
+
+#endif
+
+#endif //__KrcahSheetnessImageFilter_h_
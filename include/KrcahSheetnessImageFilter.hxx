@@ -0,0 +1,40 @@
+#ifndef __KrcahSheetnessImageFilter_hxx_
+#define __KrcahSheetnessImageFilter_hxx_
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace itk {
+    template<typename TInputImage, typename TConstant, typename TOutputImage>
+    void KrcahSheetnessImageFilter<TInputImage, TConstant, TOutputImage>
+    ::ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) {
+        const SizeValueType length = outputRegionForThread.GetSize(0);
+        if (length == 0) {
+            return;
+        }
+
+        const Input1ImageType *input = dynamic_cast<const Input1ImageType *>(ProcessObject::GetInput(0));
+        const Input2ImageType *trace = dynamic_cast<const Input2ImageType *>(ProcessObject::GetInput(1));
+        TOutputImage *output = this->GetOutput(0);
+
+        // a trace set with SetConstant2 is broadcast with a stride of 0
+        const TConstant constant = trace ? TConstant() : this->GetConstant2();
+        const std::ptrdiff_t traceStride = trace ? 1 : 0;
+
+        const typename Superclass::FunctorType &functor = this->GetFunctor();
+        ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / length);
+
+        // the buffers are contiguous along direction 0, one batch per line
+        ImageLinearConstIteratorWithIndex<TOutputImage> it(output, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const typename TOutputImage::IndexType index = it.GetIndex();
+            const TConstant *t = trace ? trace->GetBufferPointer() + trace->ComputeOffset(index) : &constant;
+            functor.Evaluate(input->GetBufferPointer() + input->ComputeOffset(index), t, traceStride,
+                             output->GetBufferPointer() + output->ComputeOffset(index), length);
+            progress.CompletedPixel();
+        }
+    }
+}
+
+#endif // __KrcahSheetnessImageFilter_hxx_
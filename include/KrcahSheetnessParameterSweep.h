@@ -0,0 +1,184 @@
+#ifndef __KrcahSheetnessParameterSweep_h_
+#define __KrcahSheetnessParameterSweep_h_
+
+#include "itkObject.h"
+#include "itkImage.h"
+#include "itkMultiThreader.h"
+
+#include "KrcahSheetnessFeatureGenerator.h"
+#include "KrcahSheetnessFunctor.h"
+
+#include <atomic>
+#include <vector>
+
+namespace itk {
+    /*
+     * Krcah sheetness for a whole grid of (alpha, beta, gamma) combinations, for calibrating the parameters.
+     *
+     * Rerunning KrcahSheetnessFeatureGenerator per combination repeats the preprocessing, the Hessians and the
+     * eigenvalues, which do not depend on alpha, beta and gamma. Here they are computed once per scale with
+     * KrcahSheetnessFeatureGenerator::GenerateEigenValuesWithSigma() and kept together with the mean trace of every
+     * scale (memory: number of scales x eigenvalue image). A single blocked traversal then evaluates every combination
+     * on every block of voxels while its eigenvalues are in cache, with the maximum absolute value over the scales as
+     * in the generator.
+     *
+     * Per combination the result is a summary (minimum, maximum, mean and, with a label image, the mean inside and
+     * outside of Label) and, with GenerateImage on, a slice of a (D+1)-dimensional image whose last index is the
+     * combination.
+     */
+    template<typename TInput>
+    class ITK_EXPORT KrcahSheetnessParameterSweep : public Object {
+    public:
+        typedef KrcahSheetnessParameterSweep Self;
+        typedef Object Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(KrcahSheetnessParameterSweep, Object);
+        itkStaticConstMacro(NDimension, unsigned int, TInput::ImageDimension);
+
+        typedef TInput InputImageType;
+        typedef float OutputPixelType;
+        typedef Image<OutputPixelType, NDimension> OutputImageType;
+        typedef Image<unsigned char, NDimension> LabelImageType;
+        typedef Image<OutputPixelType, NDimension + 1> SweepImageType;
+        typedef KrcahSheetnessFeatureGenerator<InputImageType, OutputImageType> GeneratorType;
+        typedef typename GeneratorType::SheetnessScalesType SheetnessScalesType;
+        typedef typename GeneratorType::EigenValueArrayType EigenValueArrayType;
+        typedef typename GeneratorType::EigenValueImageType EigenValueImageType;
+        typedef Functor::KrcahSheetness<EigenValueArrayType, double, OutputPixelType> FunctorType;
+
+        struct ParametersType {
+            double Alpha;
+            double Beta;
+            double Gamma;
+        };
+
+        struct StatisticsType {
+            double Minimum;
+            double Maximum;
+            double Mean;
+            double LabelMean; // mean inside Label, 0 without a label image
+            double BackgroundMean; // mean outside Label, 0 without a label image
+        };
+
+        itkSetConstObjectMacro(Input, InputImageType);
+
+        // optional, for LabelMean and BackgroundMean
+        itkSetConstObjectMacro(LabelImage, LabelImageType);
+
+        itkSetMacro(Label, unsigned char);
+        itkGetConstMacro(Label, unsigned char);
+
+        // the parameters of KrcahSheetnessFeatureGenerator that are shared by all combinations
+        itkSetMacro(GaussVariance, double);
+        itkSetMacro(ScalingConstant, double);
+        itkSetMacro(UseBoundaryFluxTraceMean, bool);
+        itkSetMacro(UseFastExp, bool);
+
+        void SetSheetnessScales(const SheetnessScalesType &v) {
+            m_SheetnessScales = v;
+            this->Modified();
+        }
+
+        // store the sheetness of every combination in a (D+1)-dimensional image
+        itkSetMacro(GenerateImage, bool);
+        itkGetConstMacro(GenerateImage, bool);
+        itkBooleanMacro(GenerateImage);
+
+        itkSetMacro(NumberOfThreads, ThreadIdType);
+        itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+        void AddParameters(double alpha, double beta, double gamma);
+
+        // every combination of the given values, gamma fastest
+        void SetParameterGrid(const std::vector<double> &alphas, const std::vector<double> &betas,
+                              const std::vector<double> &gammas);
+
+        void ClearParameters();
+
+        size_t GetNumberOfParameters() const {
+            return m_Parameters.size();
+        }
+
+        const ParametersType &GetParameters(size_t i) const {
+            return m_Parameters[i];
+        }
+
+        void Compute();
+
+        // valid after Compute()
+        const StatisticsType &GetStatistics(size_t i) const {
+            return m_Statistics[i];
+        }
+
+        // valid after Compute() with GenerateImage on, slice i of the last dimension is combination i
+        SweepImageType *GetImage() {
+            return m_Image;
+        }
+
+    protected:
+        KrcahSheetnessParameterSweep();
+
+        virtual ~KrcahSheetnessParameterSweep() {
+        }
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        KrcahSheetnessParameterSweep(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        // voxels per block of the traversal
+        static const SizeValueType BlockSize = 1024;
+
+        struct ThreadStatistics {
+            double Minimum;
+            double Maximum;
+            double Sum;
+            double LabelSum;
+        };
+
+        static ITK_THREAD_RETURN_TYPE blockThreaderCallback(void *arg);
+
+        // take blocks from the shared counter until none is left
+        void processBlocks(ThreadIdType threadId);
+
+        void processBlock(SizeValueType start, SizeValueType n, std::vector<ThreadStatistics> &statistics,
+                          SizeValueType &numberOfLabelPixels);
+
+        typename InputImageType::ConstPointer m_Input;
+        typename LabelImageType::ConstPointer m_LabelImage;
+        unsigned char m_Label;
+        double m_GaussVariance;
+        double m_ScalingConstant;
+        bool m_UseBoundaryFluxTraceMean;
+        bool m_UseFastExp;
+        SheetnessScalesType m_SheetnessScales;
+        bool m_GenerateImage;
+        ThreadIdType m_NumberOfThreads;
+
+        std::vector<ParametersType> m_Parameters;
+        std::vector<StatisticsType> m_Statistics;
+        typename SweepImageType::Pointer m_Image;
+
+        // state of Compute()
+        std::vector<typename EigenValueImageType::Pointer> m_EigenValues;
+        std::vector<double> m_TraceMeans;
+        std::vector<FunctorType> m_Functors;
+        std::vector<std::vector<ThreadStatistics> > m_ThreadStatistics;
+        std::vector<SizeValueType> m_ThreadNumberOfLabelPixels;
+        SizeValueType m_NumberOfBlocks;
+        std::atomic<SizeValueType> m_NextBlock;
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "KrcahSheetnessParameterSweep.hxx"
+
+#endif
+
+#endif //__KrcahSheetnessParameterSweep_h_
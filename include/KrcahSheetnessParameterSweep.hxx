@@ -0,0 +1,251 @@
+#ifndef __KrcahSheetnessParameterSweep_hxx_
+#define __KrcahSheetnessParameterSweep_hxx_
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace itk {
+    template<typename TInput>
+    KrcahSheetnessParameterSweep<TInput>
+    ::KrcahSheetnessParameterSweep()
+    // the defaults of KrcahSheetnessFeatureGenerator
+            : m_Label(1)
+            , m_GaussVariance(1)
+            , m_ScalingConstant(10)
+            , m_UseBoundaryFluxTraceMean(false)
+            , m_UseFastExp(false)
+            , m_GenerateImage(false)
+            , m_NumberOfThreads(MultiThreader::GetGlobalDefaultNumberOfThreads())
+            , m_NumberOfBlocks(0)
+            , m_NextBlock(0) {
+        m_SheetnessScales.push_back(0.75);
+        m_SheetnessScales.push_back(1.00);
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::AddParameters(double alpha, double beta, double gamma) {
+        ParametersType parameters;
+        parameters.Alpha = alpha;
+        parameters.Beta = beta;
+        parameters.Gamma = gamma;
+        m_Parameters.push_back(parameters);
+        this->Modified();
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::SetParameterGrid(const std::vector<double> &alphas, const std::vector<double> &betas,
+                       const std::vector<double> &gammas) {
+        m_Parameters.clear();
+        for (size_t a = 0; a < alphas.size(); ++a) {
+            for (size_t b = 0; b < betas.size(); ++b) {
+                for (size_t g = 0; g < gammas.size(); ++g) {
+                    AddParameters(alphas[a], betas[b], gammas[g]);
+                }
+            }
+        }
+        this->Modified();
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::ClearParameters() {
+        m_Parameters.clear();
+        this->Modified();
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::Compute() {
+        if (!m_Input) {
+            itkExceptionMacro(<< "No input set");
+        }
+        if (m_Parameters.empty()) {
+            itkExceptionMacro(<< "No parameters, call AddParameters() or SetParameterGrid() first");
+        }
+        if (m_SheetnessScales.empty()) {
+            itkExceptionMacro(<< "No sheetness scales");
+        }
+
+        // eigenvalues and mean trace once per scale
+        typename GeneratorType::Pointer generator = GeneratorType::New();
+        generator->SetGaussVariance(m_GaussVariance);
+        generator->SetScalingConstant(m_ScalingConstant);
+        generator->SetUseBoundaryFluxTraceMean(m_UseBoundaryFluxTraceMean);
+        m_EigenValues.clear();
+        m_TraceMeans.clear();
+        for (size_t s = 0; s < m_SheetnessScales.size(); ++s) {
+            double traceMean;
+            m_EigenValues.push_back(generator->GenerateEigenValuesWithSigma(m_Input, m_SheetnessScales[s], traceMean));
+            m_TraceMeans.push_back(traceMean);
+        }
+
+        const typename EigenValueImageType::RegionType region = m_EigenValues[0]->GetBufferedRegion();
+        if (m_LabelImage && m_LabelImage->GetBufferedRegion() != region) {
+            itkExceptionMacro(<< "The label image has to cover the input, " << m_LabelImage->GetBufferedRegion()
+                              << " instead of " << region);
+        }
+
+        m_Functors.clear();
+        for (size_t c = 0; c < m_Parameters.size(); ++c) {
+            FunctorType functor;
+            functor.SetAlpha(m_Parameters[c].Alpha);
+            functor.SetBeta(m_Parameters[c].Beta);
+            functor.SetGamma(m_Parameters[c].Gamma);
+            functor.SetUseFastExp(m_UseFastExp);
+            m_Functors.push_back(functor);
+        }
+
+        // combination as the last, slowest index
+        m_Image = ITK_NULLPTR;
+        if (m_GenerateImage) {
+            m_Image = SweepImageType::New();
+            typename SweepImageType::RegionType sweepRegion;
+            typename SweepImageType::SpacingType spacing;
+            typename SweepImageType::PointType origin;
+            for (unsigned int d = 0; d < NDimension; ++d) {
+                sweepRegion.SetIndex(d, region.GetIndex(d));
+                sweepRegion.SetSize(d, region.GetSize(d));
+                spacing[d] = m_EigenValues[0]->GetSpacing()[d];
+                origin[d] = m_EigenValues[0]->GetOrigin()[d];
+            }
+            sweepRegion.SetIndex(NDimension, 0);
+            sweepRegion.SetSize(NDimension, m_Parameters.size());
+            spacing[NDimension] = 1;
+            origin[NDimension] = 0;
+            m_Image->SetRegions(sweepRegion);
+            m_Image->SetSpacing(spacing);
+            m_Image->SetOrigin(origin);
+            m_Image->Allocate();
+        }
+
+        // one blocked traversal for all combinations
+        typename MultiThreader::Pointer threader = MultiThreader::New();
+        threader->SetNumberOfThreads(m_NumberOfThreads);
+        const ThreadIdType numberOfThreads = threader->GetNumberOfThreads();
+
+        ThreadStatistics empty;
+        empty.Minimum = std::numeric_limits<double>::max();
+        empty.Maximum = -std::numeric_limits<double>::max();
+        empty.Sum = 0;
+        empty.LabelSum = 0;
+        m_ThreadStatistics.assign(numberOfThreads, std::vector<ThreadStatistics>(m_Parameters.size(), empty));
+        m_ThreadNumberOfLabelPixels.assign(numberOfThreads, 0);
+        m_NumberOfBlocks = (region.GetNumberOfPixels() + BlockSize - 1) / BlockSize;
+        m_NextBlock = 0;
+
+        threader->SetSingleMethod(Self::blockThreaderCallback, this);
+        threader->SingleMethodExecute();
+
+        // merge the threads
+        const double numberOfPixels = region.GetNumberOfPixels();
+        SizeValueType numberOfLabelPixels = 0;
+        for (ThreadIdType t = 0; t < numberOfThreads; ++t) {
+            numberOfLabelPixels += m_ThreadNumberOfLabelPixels[t];
+        }
+        m_Statistics.resize(m_Parameters.size());
+        for (size_t c = 0; c < m_Parameters.size(); ++c) {
+            ThreadStatistics merged = empty;
+            for (ThreadIdType t = 0; t < numberOfThreads; ++t) {
+                merged.Minimum = std::min(merged.Minimum, m_ThreadStatistics[t][c].Minimum);
+                merged.Maximum = std::max(merged.Maximum, m_ThreadStatistics[t][c].Maximum);
+                merged.Sum += m_ThreadStatistics[t][c].Sum;
+                merged.LabelSum += m_ThreadStatistics[t][c].LabelSum;
+            }
+            StatisticsType &statistics = m_Statistics[c];
+            statistics.Minimum = merged.Minimum;
+            statistics.Maximum = merged.Maximum;
+            statistics.Mean = merged.Sum / numberOfPixels;
+            statistics.LabelMean = numberOfLabelPixels > 0 ? merged.LabelSum / numberOfLabelPixels : 0;
+            statistics.BackgroundMean = numberOfPixels > numberOfLabelPixels
+                                        ? (merged.Sum - merged.LabelSum) / (numberOfPixels - numberOfLabelPixels) : 0;
+        }
+
+        // release the cache
+        m_EigenValues.clear();
+        m_ThreadStatistics.clear();
+    }
+
+    template<typename TInput>
+    ITK_THREAD_RETURN_TYPE KrcahSheetnessParameterSweep<TInput>
+    ::blockThreaderCallback(void *arg) {
+        MultiThreader::ThreadInfoStruct *info = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+        static_cast<Self *>(info->UserData)->processBlocks(info->ThreadID);
+        return ITK_THREAD_RETURN_VALUE;
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::processBlocks(ThreadIdType threadId) {
+        const SizeValueType numberOfPixels = m_EigenValues[0]->GetBufferedRegion().GetNumberOfPixels();
+        for (SizeValueType b = m_NextBlock++; b < m_NumberOfBlocks; b = m_NextBlock++) {
+            const SizeValueType start = b * BlockSize;
+            const SizeValueType n = std::min(static_cast<SizeValueType>(BlockSize), numberOfPixels - start);
+            processBlock(start, n, m_ThreadStatistics[threadId], m_ThreadNumberOfLabelPixels[threadId]);
+        }
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::processBlock(SizeValueType start, SizeValueType n, std::vector<ThreadStatistics> &statistics,
+                   SizeValueType &numberOfLabelPixels) {
+        OutputPixelType best[BlockSize];
+        OutputPixelType value[BlockSize];
+
+        const unsigned char *label = m_LabelImage ? m_LabelImage->GetBufferPointer() + start : ITK_NULLPTR;
+        if (label) {
+            for (SizeValueType i = 0; i < n; ++i) {
+                numberOfLabelPixels += label[i] == m_Label;
+            }
+        }
+
+        const SizeValueType numberOfPixels = m_EigenValues[0]->GetBufferedRegion().GetNumberOfPixels();
+        for (size_t c = 0; c < m_Functors.size(); ++c) {
+            // maximum absolute value over the scales, the earlier scale wins ties as in the generator
+            m_Functors[c].Evaluate(m_EigenValues[0]->GetBufferPointer() + start, &m_TraceMeans[0], 0, best, n);
+            for (size_t s = 1; s < m_EigenValues.size(); ++s) {
+                m_Functors[c].Evaluate(m_EigenValues[s]->GetBufferPointer() + start, &m_TraceMeans[s], 0, value, n);
+                for (SizeValueType i = 0; i < n; ++i) {
+                    best[i] = vnl_math_abs(value[i]) > vnl_math_abs(best[i]) ? value[i] : best[i];
+                }
+            }
+
+            ThreadStatistics &current = statistics[c];
+            for (SizeValueType i = 0; i < n; ++i) {
+                current.Minimum = std::min<double>(current.Minimum, best[i]);
+                current.Maximum = std::max<double>(current.Maximum, best[i]);
+                current.Sum += best[i];
+            }
+            if (label) {
+                for (SizeValueType i = 0; i < n; ++i) {
+                    current.LabelSum += label[i] == m_Label ? best[i] : 0;
+                }
+            }
+
+            if (m_Image) {
+                std::memcpy(m_Image->GetBufferPointer() + c * numberOfPixels + start, best, n * sizeof(OutputPixelType));
+            }
+        }
+    }
+
+    template<typename TInput>
+    void KrcahSheetnessParameterSweep<TInput>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Input: " << m_Input.GetPointer() << std::endl;
+        os << indent << "LabelImage: " << m_LabelImage.GetPointer() << std::endl;
+        os << indent << "Label: " << static_cast<int>(m_Label) << std::endl;
+        os << indent << "GaussVariance: " << m_GaussVariance << std::endl;
+        os << indent << "ScalingConstant: " << m_ScalingConstant << std::endl;
+        os << indent << "UseBoundaryFluxTraceMean: " << m_UseBoundaryFluxTraceMean << std::endl;
+        os << indent << "UseFastExp: " << m_UseFastExp << std::endl;
+        os << indent << "NumberOfSheetnessScales: " << m_SheetnessScales.size() << std::endl;
+        os << indent << "NumberOfParameters: " << m_Parameters.size() << std::endl;
+        os << indent << "GenerateImage: " << m_GenerateImage << std::endl;
+        os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+    }
+}
+
+#endif // __KrcahSheetnessParameterSweep_hxx_
@@ -2,6 +2,7 @@
 #define __MaximumAbsoluteValueImageFilter_h_
 
 #include "itkBinaryFunctorImageFilter.h"
+#include "DynamicThreadedImageFilter.h"
 
 namespace itk {
     namespace Functor {
@@ -22,15 +23,15 @@ namespace itk {
 
     template<typename TInputImage1, typename TInputImage2, typename TOutputImage>
     class MaximumAbsoluteValueImageFilter :
-            public BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage,
+            public DynamicThreadedImageFilter<BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage,
                     Functor::MaximumAbsoluteValue<typename TInputImage1::PixelType, typename TInputImage2::PixelType,
-                            typename TOutputImage::PixelType> > {
+                            typename TOutputImage::PixelType> > > {
     public:
         // itk requirements
         typedef MaximumAbsoluteValueImageFilter Self;
-        typedef BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage,
+        typedef DynamicThreadedImageFilter<BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage,
                 Functor::MaximumAbsoluteValue<typename TInputImage1::PixelType, typename TInputImage2::PixelType,
-                        typename TOutputImage::PixelType> > Superclass;
+                        typename TOutputImage::PixelType> > > Superclass;
         typedef SmartPointer<Self> Pointer;
         typedef SmartPointer<const Self> ConstPointer;
 
@@ -0,0 +1,106 @@
+#ifndef __MeanTraceBoundaryFluxCalculator_h_
+#define __MeanTraceBoundaryFluxCalculator_h_
+
+#include "itkObject.h"
+#include "itkImage.h"
+#include "itkRecursiveGaussianImageFilter.h"
+
+#include <vector>
+
+namespace itk {
+    /*
+     * Mean of the trace of the Hessian (the Laplacian) of an image convolved with a Gaussian, without computing
+     * the Hessian. Gives the same value as SharedPassHessianRecursiveGaussianImageFilter (or
+     * HessianRecursiveGaussianImageFilter) -> TraceImageFilter -> StatisticsImageFilter::GetMean().
+     *
+     * This is the discrete divergence theorem. Every Hessian diagonal element is a separable linear operator
+     * A_x (x) A_y (x) A_z applied to the image, one recursive 1D pass per direction. Summed over all voxels it becomes
+     *
+     *   sum_i (A s)_i = sum_j c_j s_j,  c = A^T 1 (the column sums of the 1D operators)
+     *
+     * A second derivative kernel sums to zero, so the column sums of the second order pass vanish everywhere except
+     * for a few sigma at both ends of a line where the boundary conditions of the recursive filter kick in. Only
+     * the voxels in the slabs along the six boundary faces contribute, O(sigma N^(2/3)) work instead of a full Hessian,
+     * trace image and statistics pass.
+     *
+     * The column sums are measured on 1D impulses with the same recursive filter, so the result is exact up to
+     * rounding. Should the interior column sum of the second order pass not be zero for some parameters, the remaining
+     * term is added with one pass over the whole image instead of being ignored.
+     */
+    template<typename TInputImage>
+    class ITK_EXPORT MeanTraceBoundaryFluxCalculator : public Object {
+    public:
+        typedef MeanTraceBoundaryFluxCalculator Self;
+        typedef Object Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(MeanTraceBoundaryFluxCalculator, Object);
+        itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+        typedef TInputImage ImageType;
+        typedef typename ImageType::ConstPointer ImageConstPointer;
+        typedef typename ImageType::RegionType RegionType;
+
+        // single lines the column sums are measured on
+        typedef Image<double, 1> LineImageType;
+        typedef RecursiveGaussianImageFilter<LineImageType, LineImageType> LineFilterType;
+        typedef std::vector<double> WeightsType;
+
+        itkSetConstObjectMacro(Image, ImageType);
+
+        itkSetMacro(Sigma, double);
+        itkGetConstMacro(Sigma, double);
+
+        itkSetMacro(NormalizeAcrossScale, bool);
+        itkGetConstMacro(NormalizeAcrossScale, bool);
+        itkBooleanMacro(NormalizeAcrossScale);
+
+        void Compute();
+
+        // mean trace of the Hessian, valid after Compute()
+        itkGetConstMacro(Mean, double);
+
+        // number of image voxels read by the last Compute(), to compare against the number of voxels of the image
+        itkGetConstMacro(NumberOfVisitedPixels, SizeValueType);
+
+    protected:
+        MeanTraceBoundaryFluxCalculator();
+
+        virtual ~MeanTraceBoundaryFluxCalculator() {
+        }
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        MeanTraceBoundaryFluxCalculator(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        // column sums of one recursive pass along a line of the given length. Only the ends are measured, the rest
+        // is filled with the interior value. width is the number of entries at each end that differ from it.
+        void computeColumnSums(SizeValueType length, double spacing, unsigned int order, WeightsType &weights,
+                               double &interior, SizeValueType &width) const;
+
+        // sum of the response of the line filter to a unit impulse at position
+        double impulseResponseSum(LineFilterType *filter, LineImageType *line, SizeValueType position) const;
+
+        // weighted sum over a region, the weight of a voxel is the product of the per direction weights
+        double weightedSum(const RegionType &region, const WeightsType *weights);
+
+        ImageConstPointer m_Image;
+        double m_Sigma;
+        bool m_NormalizeAcrossScale;
+        double m_Mean;
+        SizeValueType m_NumberOfVisitedPixels;
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "MeanTraceBoundaryFluxCalculator.hxx"
+
+#endif
+
+#endif //__MeanTraceBoundaryFluxCalculator_h_
@@ -0,0 +1,174 @@
+#ifndef __MeanTraceBoundaryFluxCalculator_hxx_
+#define __MeanTraceBoundaryFluxCalculator_hxx_
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+    template<typename TInputImage>
+    MeanTraceBoundaryFluxCalculator<TInputImage>
+    ::MeanTraceBoundaryFluxCalculator()
+            : m_Sigma(1.0), m_NormalizeAcrossScale(false), m_Mean(0.0), m_NumberOfVisitedPixels(0) {
+    }
+
+    template<typename TInputImage>
+    void MeanTraceBoundaryFluxCalculator<TInputImage>
+    ::Compute() {
+        if (!m_Image) {
+            itkExceptionMacro(<< "No image set");
+        }
+
+        const RegionType region = m_Image->GetBufferedRegion();
+        const typename ImageType::SpacingType spacing = m_Image->GetSpacing();
+
+        // column sums of the smoothing (order 0) and second derivative (order 2) pass along every direction
+        WeightsType smoothing[ImageDimension];
+        WeightsType derivative[ImageDimension];
+        double interior[ImageDimension];
+        SizeValueType width[ImageDimension];
+        for (unsigned int d = 0; d < ImageDimension; ++d) {
+            double smoothingInterior;
+            SizeValueType smoothingWidth;
+            computeColumnSums(region.GetSize(d), spacing[d], 0, smoothing[d], smoothingInterior, smoothingWidth);
+            computeColumnSums(region.GetSize(d), spacing[d], 2, derivative[d], interior[d], width[d]);
+        }
+
+        m_NumberOfVisitedPixels = 0;
+        double sum = 0;
+        for (unsigned int d = 0; d < ImageDimension; ++d) {
+            // the d-th diagonal element, second derivative along d and smoothing along the others
+            WeightsType weights[ImageDimension];
+            for (unsigned int e = 0; e < ImageDimension; ++e) {
+                weights[e] = smoothing[e];
+            }
+            weights[d] = derivative[d];
+            for (SizeValueType i = 0; i < weights[d].size(); ++i) {
+                weights[d][i] -= interior[d];
+            }
+
+            // the slabs along the two faces perpendicular to d
+            if (2 * width[d] >= region.GetSize(d)) {
+                sum += weightedSum(region, weights);
+            } else if (width[d] > 0) {
+                RegionType slab = region;
+                slab.SetSize(d, width[d]);
+                sum += weightedSum(slab, weights);
+                slab.SetIndex(d, region.GetIndex(d) + region.GetSize(d) - width[d]);
+                sum += weightedSum(slab, weights);
+            }
+
+            // a second derivative pass that does not sum to zero in the interior needs the whole image
+            if (interior[d] != 0) {
+                itkDebugMacro(<< "Interior column sum " << interior[d] << " along " << d << ", summing the whole image");
+                weights[d].assign(region.GetSize(d), interior[d]);
+                sum += weightedSum(region, weights);
+            }
+        }
+
+        m_Mean = sum / region.GetNumberOfPixels();
+    }
+
+    template<typename TInputImage>
+    void MeanTraceBoundaryFluxCalculator<TInputImage>
+    ::computeColumnSums(SizeValueType length, double spacing, unsigned int order, WeightsType &weights,
+                        double &interior, SizeValueType &width) const {
+        typename LineImageType::Pointer line = LineImageType::New();
+        typename LineImageType::SizeType size = {{length}};
+        line->SetRegions(size);
+        typename LineImageType::SpacingType lineSpacing;
+        lineSpacing[0] = spacing;
+        line->SetSpacing(lineSpacing);
+        line->Allocate();
+
+        typename LineFilterType::Pointer filter = LineFilterType::New();
+        filter->SetDirection(0);
+        filter->SetSigma(m_Sigma);
+        filter->SetNormalizeAcrossScale(m_NormalizeAcrossScale);
+        filter->SetNumberOfThreads(1);
+        filter->InPlaceOff(); // the line is reused for every impulse
+        if (order == 0) {
+            filter->SetZeroOrder();
+        } else if (order == 1) {
+            filter->SetFirstOrder();
+        } else {
+            filter->SetSecondOrder();
+        }
+        filter->SetInput(line);
+
+        // column sum away from both ends, the kernel sum
+        interior = impulseResponseSum(filter, line, length / 2);
+
+        // walk in from both ends until the column sums settle on the interior value
+        weights.assign(length, interior);
+        width = 0;
+        double scale = std::fabs(interior);
+        const SizeValueType half = (length + 1) / 2;
+        const SizeValueType settled = 3;
+        for (SizeValueType j = 0; j < half && j < width + settled; ++j) {
+            weights[j] = impulseResponseSum(filter, line, j);
+            weights[length - 1 - j] = impulseResponseSum(filter, line, length - 1 - j);
+            const double deviation = std::max(std::fabs(weights[j] - interior),
+                                              std::fabs(weights[length - 1 - j] - interior));
+            scale = std::max(scale, deviation);
+            if (deviation > 1e-9 * scale) {
+                width = j + 1;
+            }
+        }
+
+        // a kernel sum that is zero up to rounding is zero, otherwise the whole image would be summed for nothing
+        if (order > 0 && std::fabs(interior) <= 1e-9 * scale) {
+            interior = 0;
+        }
+    }
+
+    template<typename TInputImage>
+    double MeanTraceBoundaryFluxCalculator<TInputImage>
+    ::impulseResponseSum(LineFilterType *filter, LineImageType *line, SizeValueType position) const {
+        line->FillBuffer(0);
+        typename LineImageType::IndexType index = {{static_cast<IndexValueType>(position)}};
+        line->SetPixel(index, 1);
+        line->Modified();
+        filter->Update();
+
+        double sum = 0;
+        ImageRegionConstIterator<LineImageType> it(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+        for (; !it.IsAtEnd(); ++it) {
+            sum += it.Get();
+        }
+        return sum;
+    }
+
+    template<typename TInputImage>
+    double MeanTraceBoundaryFluxCalculator<TInputImage>
+    ::weightedSum(const RegionType &region, const WeightsType *weights) {
+        const typename ImageType::IndexType start = m_Image->GetBufferedRegion().GetIndex();
+        double sum = 0;
+        ImageRegionConstIteratorWithIndex<ImageType> it(m_Image, region);
+        for (; !it.IsAtEnd(); ++it) {
+            const typename ImageType::IndexType index = it.GetIndex();
+            double weight = 1;
+            for (unsigned int d = 0; d < ImageDimension; ++d) {
+                weight *= weights[d][index[d] - start[d]];
+            }
+            sum += weight * it.Get();
+        }
+        m_NumberOfVisitedPixels += region.GetNumberOfPixels();
+        return sum;
+    }
+
+    template<typename TInputImage>
+    void MeanTraceBoundaryFluxCalculator<TInputImage>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Image: " << m_Image.GetPointer() << std::endl;
+        os << indent << "Sigma: " << m_Sigma << std::endl;
+        os << indent << "NormalizeAcrossScale: " << m_NormalizeAcrossScale << std::endl;
+        os << indent << "Mean: " << m_Mean << std::endl;
+        os << indent << "NumberOfVisitedPixels: " << m_NumberOfVisitedPixels << std::endl;
+    }
+}
+
+#endif // __MeanTraceBoundaryFluxCalculator_hxx_
@@ -3,6 +3,8 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "vnl/vnl_math.h"
+#include "FastExp.h"
+#include "DynamicThreadedImageFilter.h"
 
 namespace itk {
 
@@ -15,6 +17,7 @@ public:
     m_Alpha = 0.5;              // Suggested value from Vesselness paper
     m_C     = 1.0;              // Should be tuned from data
     m_DetectBrightSheets = -1;  // Detect bright sheets is default
+    m_UseFastExp = false;
   }
   ~ModifiedSheetness() {}
   bool operator!=( const ModifiedSheetness & ) const {
@@ -51,8 +54,8 @@ public:
 
     // Calculate sheetness
     sheetness  =         m_DetectBrightSheets * (a3 / l3);
-    sheetness *=         vcl_exp( - ( Rt * Rt ) / ( 2.0 * m_Alpha  * m_Alpha  ) ); 
-    sheetness *= ( 1.0 - vcl_exp( - ( Rn * Rn ) / ( 2.0 * m_C     * m_C     ) ) ); 
+    sheetness *=         exponential( - ( Rt * Rt ) / ( 2.0 * m_Alpha  * m_Alpha  ) ); 
+    sheetness *= ( 1.0 - exponential( - ( Rn * Rn ) / ( 2.0 * m_C     * m_C     ) ) ); 
 
     return static_cast<TOutput>( sheetness );
   }
@@ -118,28 +121,42 @@ public:
     return  (m_DetectBrightSheets == -1);
   }
 
+  // evaluate the exponentials with FastExp, relative error below FastExpMaximumRelativeError
+  void SetUseFastExp(bool value) {
+    m_UseFastExp = value;
+  }
+
+  bool GetUseFastExp() {
+    return m_UseFastExp;
+  }
+
 private:
+  inline double exponential(double x) const {
+    return m_UseFastExp ? FastExp(x) : vcl_exp(x);
+  }
+
   double    m_Alpha;
   double    m_C;
   double    m_DetectBrightSheets;
+  bool      m_UseFastExp;
 }; // class ModifiedSheetness
 } // namespace Functor
 
 template <class TInputImage, class TOutputImage>
 class ITK_EXPORT ModifiedSheetnessImageFilter :
     public
-UnaryFunctorImageFilter<TInputImage,TOutputImage, 
+DynamicThreadedImageFilter<UnaryFunctorImageFilter<TInputImage,TOutputImage, 
 Functor::ModifiedSheetness< typename TInputImage::PixelType, 
-                                       typename TOutputImage::PixelType>   >
+                                       typename TOutputImage::PixelType>   > >
 {
 public:
   /** Standard class typedefs. */
   typedef ModifiedSheetnessImageFilter    Self;
-  typedef UnaryFunctorImageFilter<
+  typedef DynamicThreadedImageFilter<UnaryFunctorImageFilter<
     TInputImage,TOutputImage, 
     Functor::ModifiedSheetness< 
       typename TInputImage::PixelType, 
-      typename TOutputImage::PixelType> >   Superclass;
+      typename TOutputImage::PixelType> > >   Superclass;
   typedef SmartPointer<Self>                Pointer;
   typedef SmartPointer<const Self>          ConstPointer;
 
@@ -166,6 +183,11 @@ public:
     this->GetFunctor().DetectDarkSheetsOn();
   }
 
+  /** Evaluate the exponentials with FastExp instead of exp. */
+  void SetUseFastExp( bool value ) {
+    this->GetFunctor().SetUseFastExp( value );
+  }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   typedef typename TInputImage::PixelType InputPixelType;
@@ -0,0 +1,145 @@
+#ifndef __MultiMeasureSheetnessImageFilter_h_
+#define __MultiMeasureSheetnessImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "KrcahSheetnessFunctor.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace itk {
+    /*
+     * Several sheetness measures of one eigenvalue image in a single traversal, one output per measure.
+     *
+     * Measures are registered with AddMeasure() before the update, as a copy of a configured functor:
+     * - a unary functor of the eigenvalues, e.g. Functor::ModifiedSheetness or Functor::DescoteauxSheetness
+     * - a binary functor of the eigenvalues and a constant trace, e.g. Functor::KrcahSheetness with the mean trace
+     *
+     * The image is walked one scanline at a time and every measure is evaluated on the line while it is in cache,
+     * instead of one Hessian / eigen analysis / sheetness pipeline per measure. KrcahSheetness uses its batch API.
+     * Output i holds the measure returned as index i by AddMeasure().
+     */
+    template<typename TInputImage, typename TOutputImage>
+    class ITK_EXPORT MultiMeasureSheetnessImageFilter : public ImageToImageFilter<TInputImage, TOutputImage> {
+    public:
+        typedef MultiMeasureSheetnessImageFilter Self;
+        typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(MultiMeasureSheetnessImageFilter, ImageToImageFilter);
+
+        typedef TInputImage InputImageType;
+        typedef TOutputImage OutputImageType;
+        typedef typename InputImageType::PixelType InputPixelType;
+        typedef typename OutputImageType::PixelType OutputPixelType;
+        typedef typename OutputImageType::RegionType OutputImageRegionType;
+
+        // register a unary functor of the eigenvalues, returns the index of its output
+        template<typename TFunctor>
+        unsigned int AddMeasure(const TFunctor &functor) {
+            return addMeasure(new UnaryMeasure<TFunctor>(functor));
+        }
+
+        // register a binary functor of the eigenvalues and the trace, with a constant trace
+        template<typename TFunctor>
+        unsigned int AddMeasure(const TFunctor &functor, double trace) {
+            return addMeasure(new ConstantTraceMeasure<TFunctor>(functor, trace));
+        }
+
+        unsigned int GetNumberOfMeasures() const {
+            return static_cast<unsigned int>(m_Measures.size());
+        }
+
+        void ClearMeasures();
+
+    protected:
+        MultiMeasureSheetnessImageFilter();
+
+        virtual ~MultiMeasureSheetnessImageFilter() {
+        }
+
+        void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+        void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        MultiMeasureSheetnessImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        // a registered functor, evaluated on a whole scanline per call
+        class Measure {
+        public:
+            virtual ~Measure() {
+            }
+
+            virtual void EvaluateLine(const InputPixelType *input, OutputPixelType *output, size_t n) const = 0;
+        };
+
+        template<typename TFunctor>
+        class UnaryMeasure : public Measure {
+        public:
+            explicit UnaryMeasure(const TFunctor &functor) : m_Functor(functor) {
+            }
+
+            void EvaluateLine(const InputPixelType *input, OutputPixelType *output, size_t n) const ITK_OVERRIDE {
+                TFunctor functor = m_Functor; // the functors of this repo are not const-callable
+                for (size_t i = 0; i < n; ++i) {
+                    output[i] = static_cast<OutputPixelType>(functor(input[i]));
+                }
+            }
+
+        private:
+            TFunctor m_Functor;
+        };
+
+        template<typename TFunctor>
+        class ConstantTraceMeasure : public Measure {
+        public:
+            ConstantTraceMeasure(const TFunctor &functor, double trace) : m_Functor(functor), m_Trace(trace) {
+            }
+
+            void EvaluateLine(const InputPixelType *input, OutputPixelType *output, size_t n) const ITK_OVERRIDE {
+                evaluateLine(m_Functor, m_Trace, input, output, n);
+            }
+
+        private:
+            TFunctor m_Functor;
+            double m_Trace;
+        };
+
+        template<typename TFunctor>
+        static void evaluateLine(const TFunctor &f, double trace, const InputPixelType *input, OutputPixelType *output,
+                                 size_t n) {
+            TFunctor functor = f;
+            for (size_t i = 0; i < n; ++i) {
+                output[i] = static_cast<OutputPixelType>(functor(input[i], trace));
+            }
+        }
+
+        // KrcahSheetness has a batch API for whole lines
+        template<typename TTracePixel>
+        static void evaluateLine(const Functor::KrcahSheetness<InputPixelType, TTracePixel, OutputPixelType> &functor,
+                                 double trace, const InputPixelType *input, OutputPixelType *output, size_t n) {
+            const TTracePixel t = static_cast<TTracePixel>(trace);
+            functor.Evaluate(input, &t, 0, output, n);
+        }
+
+        unsigned int addMeasure(Measure *measure);
+
+        std::vector<std::shared_ptr<const Measure> > m_Measures;
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "MultiMeasureSheetnessImageFilter.hxx"
+
+#endif
+
+#endif //__MultiMeasureSheetnessImageFilter_h_
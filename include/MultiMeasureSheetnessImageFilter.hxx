@@ -0,0 +1,84 @@
+#ifndef __MultiMeasureSheetnessImageFilter_hxx_
+#define __MultiMeasureSheetnessImageFilter_hxx_
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+
+namespace itk {
+    template<typename TInputImage, typename TOutputImage>
+    MultiMeasureSheetnessImageFilter<TInputImage, TOutputImage>
+    ::MultiMeasureSheetnessImageFilter() {
+        this->SetNumberOfRequiredInputs(1);
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    unsigned int MultiMeasureSheetnessImageFilter<TInputImage, TOutputImage>
+    ::addMeasure(Measure *measure) {
+        const unsigned int index = static_cast<unsigned int>(m_Measures.size());
+        m_Measures.push_back(std::shared_ptr<const Measure>(measure));
+
+        // output 0 exists from the start
+        this->SetNumberOfRequiredOutputs(index + 1);
+        if (index > 0) {
+            this->SetNthOutput(index, this->MakeOutput(index));
+        }
+        this->Modified();
+        return index;
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void MultiMeasureSheetnessImageFilter<TInputImage, TOutputImage>
+    ::ClearMeasures() {
+        m_Measures.clear();
+        this->SetNumberOfRequiredOutputs(1);
+        this->SetNumberOfIndexedOutputs(1);
+        this->Modified();
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void MultiMeasureSheetnessImageFilter<TInputImage, TOutputImage>
+    ::BeforeThreadedGenerateData() {
+        if (m_Measures.empty()) {
+            itkExceptionMacro(<< "No measure registered, call AddMeasure() before the update");
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void MultiMeasureSheetnessImageFilter<TInputImage, TOutputImage>
+    ::ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) {
+        const SizeValueType length = outputRegionForThread.GetSize(0);
+        if (length == 0) {
+            return;
+        }
+
+        const InputImageType *input = this->GetInput();
+        std::vector<OutputImageType *> outputs(m_Measures.size());
+        for (unsigned int m = 0; m < m_Measures.size(); ++m) {
+            outputs[m] = this->GetOutput(m);
+        }
+
+        ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / length);
+
+        // the buffers are contiguous along direction 0, every measure runs on the line before the next line is read
+        ImageLinearConstIteratorWithIndex<InputImageType> it(input, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const typename InputImageType::IndexType index = it.GetIndex();
+            const InputPixelType *line = input->GetBufferPointer() + input->ComputeOffset(index);
+            for (unsigned int m = 0; m < m_Measures.size(); ++m) {
+                OutputImageType *output = outputs[m];
+                m_Measures[m]->EvaluateLine(line, output->GetBufferPointer() + output->ComputeOffset(index), length);
+            }
+            progress.CompletedPixel();
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void MultiMeasureSheetnessImageFilter<TInputImage, TOutputImage>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "NumberOfMeasures: " << m_Measures.size() << std::endl;
+    }
+}
+
+#endif // __MultiMeasureSheetnessImageFilter_hxx_
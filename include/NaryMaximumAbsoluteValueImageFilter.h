@@ -0,0 +1,82 @@
+#ifndef __NaryMaximumAbsoluteValueImageFilter_h_
+#define __NaryMaximumAbsoluteValueImageFilter_h_
+
+#include "itkInPlaceImageFilter.h"
+#include "itkImage.h"
+#include "DynamicThreadedImageFilter.h"
+
+namespace itk {
+    /*
+     * Value with the largest absolute value over any number of inputs, the N-input version of
+     * MaximumAbsoluteValueImageFilter. All inputs are reduced in one threaded traversal instead of a chain of N-1
+     * binary filters with one output allocation each. With InPlaceOn() the result is written into the buffer of
+     * input 0 and nothing is allocated for output 0.
+     *
+     * Ties go to the lower input, as in MaximumAbsoluteValueImageFilter. With GenerateIndexOutputOn() output 1 holds
+     * the number of the input the value was taken from, e.g. the scale of a multi-scale measure.
+     *
+     * The inputs are set with SetInput(i, image) or PushBackInput(image) and must cover the output requested region.
+     */
+    template<typename TInputImage, typename TOutputImage = TInputImage,
+            typename TIndexImage = Image<unsigned char, TInputImage::ImageDimension> >
+    class ITK_EXPORT NaryMaximumAbsoluteValueImageFilter
+            : public DynamicThreadedImageFilter<InPlaceImageFilter<TInputImage, TOutputImage> > {
+    public:
+        typedef NaryMaximumAbsoluteValueImageFilter Self;
+        typedef DynamicThreadedImageFilter<InPlaceImageFilter<TInputImage, TOutputImage> > Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(NaryMaximumAbsoluteValueImageFilter, InPlaceImageFilter);
+        itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+        typedef TInputImage InputImageType;
+        typedef typename InputImageType::PixelType InputPixelType;
+        typedef TOutputImage OutputImageType;
+        typedef typename OutputImageType::PixelType OutputPixelType;
+        typedef typename OutputImageType::RegionType OutputImageRegionType;
+        typedef TIndexImage IndexImageType;
+        typedef typename IndexImageType::PixelType IndexPixelType;
+
+        typedef typename Superclass::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
+
+        // add output 1 with the number of the winning input
+        void SetGenerateIndexOutput(bool b);
+        itkGetConstMacro(GenerateIndexOutput, bool);
+        itkBooleanMacro(GenerateIndexOutput);
+
+        // output 1, ITK_NULLPTR unless GenerateIndexOutputOn()
+        IndexImageType *GetIndexOutput();
+
+        using Superclass::MakeOutput;
+        DataObject::Pointer MakeOutput(DataObjectPointerArraySizeType idx) ITK_OVERRIDE;
+
+    protected:
+        NaryMaximumAbsoluteValueImageFilter();
+
+        virtual ~NaryMaximumAbsoluteValueImageFilter() {
+        }
+
+        void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+        void ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        NaryMaximumAbsoluteValueImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        bool m_GenerateIndexOutput;
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "NaryMaximumAbsoluteValueImageFilter.hxx"
+
+#endif
+
+#endif //__NaryMaximumAbsoluteValueImageFilter_h_
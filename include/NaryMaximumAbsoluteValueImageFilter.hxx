@@ -0,0 +1,138 @@
+#ifndef __NaryMaximumAbsoluteValueImageFilter_hxx_
+#define __NaryMaximumAbsoluteValueImageFilter_hxx_
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include "vnl/vnl_math.h"
+
+#include <vector>
+
+namespace itk {
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::NaryMaximumAbsoluteValueImageFilter()
+            : m_GenerateIndexOutput(false) {
+        this->SetNumberOfRequiredInputs(1);
+        this->InPlaceOff();
+    }
+
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    void NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::SetGenerateIndexOutput(bool b) {
+        if (b == m_GenerateIndexOutput) {
+            return;
+        }
+        m_GenerateIndexOutput = b;
+        if (b) {
+            this->SetNumberOfRequiredOutputs(2);
+            this->SetNthOutput(1, this->MakeOutput(1));
+        } else {
+            this->SetNumberOfRequiredOutputs(1);
+            this->SetNumberOfIndexedOutputs(1);
+        }
+        this->Modified();
+    }
+
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    typename NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>::IndexImageType *
+    NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::GetIndexOutput() {
+        if (!m_GenerateIndexOutput) {
+            return ITK_NULLPTR;
+        }
+        return dynamic_cast<IndexImageType *>(this->ProcessObject::GetOutput(1));
+    }
+
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    DataObject::Pointer NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::MakeOutput(DataObjectPointerArraySizeType idx) {
+        if (idx == 1) {
+            return IndexImageType::New().GetPointer();
+        }
+        return Superclass::MakeOutput(idx);
+    }
+
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    void NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::BeforeThreadedGenerateData() {
+        const unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
+        for (unsigned int k = 0; k < numberOfInputs; ++k) {
+            if (!this->GetInput(k)) {
+                itkExceptionMacro(<< "Input " << k << " is not set");
+            }
+        }
+        if (m_GenerateIndexOutput
+            && numberOfInputs - 1 > static_cast<unsigned long>(NumericTraits<IndexPixelType>::max())) {
+            itkExceptionMacro(<< numberOfInputs << " inputs can not be numbered with the index pixel type");
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    void NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::ThreadedGenerateData(const OutputImageRegionType &outputRegionForThread, ThreadIdType threadId) {
+        const SizeValueType size0 = outputRegionForThread.GetSize(0);
+        if (size0 == 0) {
+            return;
+        }
+
+        const unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
+        std::vector<const InputImageType *> inputs(numberOfInputs);
+        for (unsigned int k = 0; k < numberOfInputs; ++k) {
+            inputs[k] = this->GetInput(k);
+        }
+        OutputImageType *output = this->GetOutput();
+        IndexImageType *indexOutput = GetIndexOutput();
+
+        const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+        ProgressReporter progress(this, threadId, numberOfLinesToProcess);
+
+        ImageLinearConstIteratorWithIndex<OutputImageType> it(output, outputRegionForThread);
+        it.SetDirection(0);
+        for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine()) {
+            const typename OutputImageType::IndexType index = it.GetIndex();
+            OutputPixelType *lineOut = output->GetBufferPointer() + output->ComputeOffset(index);
+            IndexPixelType *lineIndex = indexOutput
+                                        ? indexOutput->GetBufferPointer() + indexOutput->ComputeOffset(index)
+                                        : ITK_NULLPTR;
+
+            // input 0 is the first candidate, already in place when the output shares its buffer
+            const InputPixelType *line = inputs[0]->GetBufferPointer() + inputs[0]->ComputeOffset(index);
+            if (static_cast<const void *>(line) != static_cast<const void *>(lineOut)) {
+                for (SizeValueType i = 0; i < size0; ++i) {
+                    lineOut[i] = static_cast<OutputPixelType>(line[i]);
+                }
+            }
+            if (lineIndex) {
+                for (SizeValueType i = 0; i < size0; ++i) {
+                    lineIndex[i] = NumericTraits<IndexPixelType>::ZeroValue();
+                }
+            }
+
+            // one contiguous pass per input, only a strictly larger absolute value replaces the candidate
+            for (unsigned int k = 1; k < numberOfInputs; ++k) {
+                line = inputs[k]->GetBufferPointer() + inputs[k]->ComputeOffset(index);
+                const IndexPixelType number = static_cast<IndexPixelType>(k);
+                for (SizeValueType i = 0; i < size0; ++i) {
+                    const OutputPixelType value = static_cast<OutputPixelType>(line[i]);
+                    if (vnl_math_abs(value) > vnl_math_abs(lineOut[i])) {
+                        lineOut[i] = value;
+                        if (lineIndex) {
+                            lineIndex[i] = number;
+                        }
+                    }
+                }
+            }
+            progress.CompletedPixel();
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage, typename TIndexImage>
+    void NaryMaximumAbsoluteValueImageFilter<TInputImage, TOutputImage, TIndexImage>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "GenerateIndexOutput: " << m_GenerateIndexOutput << std::endl;
+    }
+}
+
+#endif // __NaryMaximumAbsoluteValueImageFilter_hxx_
@@ -0,0 +1,175 @@
+#ifndef __PerformanceTelemetry_h_
+#define __PerformanceTelemetry_h_
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace itk {
+    /*
+     * Collects per-stage performance records (wall time, CPU time, thread count, bytes, voxels/s).
+     *
+     * Filters that accept a telemetry object call StartStage() / StopStage() around each of their
+     * internal stages. A single telemetry object can be shared by several filters, the records are
+     * appended in the order the stages finish. WriteJSON() emits all records for monitoring.
+     *
+     * CPU time is process time as reported by std::clock(), so it includes all threads of the stage.
+     * Bytes are the sizes of the buffers the stage allocated (its output images).
+     */
+    class PerformanceTelemetry : public Object {
+    public:
+        typedef PerformanceTelemetry Self;
+        typedef Object Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(PerformanceTelemetry, Object);
+
+        struct StageRecord {
+            std::string Name;
+            double WallTime;            // seconds
+            double CPUTime;             // seconds, summed over all threads
+            ThreadIdType NumberOfThreads;
+            SizeValueType NumberOfBytes;
+            SizeValueType NumberOfVoxels;
+
+            double GetVoxelsPerSecond() const {
+                return WallTime > 0 ? NumberOfVoxels / WallTime : 0;
+            }
+        };
+        typedef std::vector<StageRecord> StageRecordContainerType;
+
+        void StartStage(const std::string &name) {
+            StartTimeType &start = m_Running[name];
+            start.first = std::chrono::steady_clock::now();
+            start.second = std::clock();
+        }
+
+        void StopStage(const std::string &name, SizeValueType numberOfVoxels, SizeValueType numberOfBytes,
+                       ThreadIdType numberOfThreads) {
+            std::clock_t cpuStop = std::clock();
+            std::chrono::steady_clock::time_point wallStop = std::chrono::steady_clock::now();
+
+            RunningStageContainerType::iterator it = m_Running.find(name);
+            if (it == m_Running.end()) {
+                itkWarningMacro(<< "StopStage() called for stage '" << name << "' which was never started.");
+                return;
+            }
+
+            StageRecord record;
+            record.Name = name;
+            record.WallTime = std::chrono::duration<double>(wallStop - it->second.first).count();
+            record.CPUTime = static_cast<double>(cpuStop - it->second.second) / CLOCKS_PER_SEC;
+            record.NumberOfThreads = numberOfThreads;
+            record.NumberOfBytes = numberOfBytes;
+            record.NumberOfVoxels = numberOfVoxels;
+            m_Stages.push_back(record);
+            m_Running.erase(it);
+        }
+
+        const StageRecordContainerType &GetStages() const {
+            return m_Stages;
+        }
+
+        // scalar values that are not tied to a stage, e.g. the peak resident set size of a benchmark
+        void SetMetric(const std::string &name, double value) {
+            m_Metrics[name] = value;
+        }
+
+        const std::map<std::string, double> &GetMetrics() const {
+            return m_Metrics;
+        }
+
+        void Clear() {
+            m_Stages.clear();
+            m_Running.clear();
+            m_Metrics.clear();
+        }
+
+        // size of the pixel buffer of an image
+        template<typename TImage>
+        static SizeValueType GetImageBufferSize(const TImage *image) {
+            if (image == ITK_NULLPTR) {
+                return 0;
+            }
+            return image->GetBufferedRegion().GetNumberOfPixels() * sizeof(typename TImage::PixelType);
+        }
+
+        void WriteJSON(std::ostream &os) const {
+            os << "{\n";
+            if (!m_Metrics.empty()) {
+                os << "  \"metrics\": {";
+                for (std::map<std::string, double>::const_iterator it = m_Metrics.begin(); it != m_Metrics.end(); ++it) {
+                    os << (it == m_Metrics.begin() ? "\n" : ",\n")
+                       << "    \"" << escape(it->first) << "\": " << it->second;
+                }
+                os << "\n  },\n";
+            }
+            os << "  \"stages\": [";
+            for (size_t i = 0; i < m_Stages.size(); ++i) {
+                const StageRecord &s = m_Stages[i];
+                os << (i == 0 ? "\n" : ",\n")
+                   << "    {\"name\": \"" << escape(s.Name) << "\""
+                   << ", \"wall_time_s\": " << s.WallTime
+                   << ", \"cpu_time_s\": " << s.CPUTime
+                   << ", \"threads\": " << s.NumberOfThreads
+                   << ", \"bytes\": " << s.NumberOfBytes
+                   << ", \"voxels\": " << s.NumberOfVoxels
+                   << ", \"voxels_per_s\": " << s.GetVoxelsPerSecond() << "}";
+            }
+            os << (m_Stages.empty() ? "" : "\n  ") << "]\n}\n";
+        }
+
+        void WriteJSON(const std::string &fileName) const {
+            std::ofstream file(fileName.c_str());
+            if (!file) {
+                itkExceptionMacro(<< "Could not open " << fileName << " for writing.");
+            }
+            WriteJSON(file);
+        }
+
+    protected:
+        PerformanceTelemetry() {}
+
+        virtual ~PerformanceTelemetry() {}
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE {
+            Superclass::PrintSelf(os, indent);
+            os << indent << "Number of stages: " << m_Stages.size() << std::endl;
+        }
+
+    private:
+        PerformanceTelemetry(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        static std::string escape(const std::string &s) {
+            std::string escaped;
+            for (size_t i = 0; i < s.size(); ++i) {
+                if (s[i] == '"' || s[i] == '\\') {
+                    escaped += '\\';
+                }
+                escaped += s[i];
+            }
+            return escaped;
+        }
+
+        typedef std::pair<std::chrono::steady_clock::time_point, std::clock_t> StartTimeType;
+        typedef std::map<std::string, StartTimeType> RunningStageContainerType;
+
+        StageRecordContainerType m_Stages;
+        RunningStageContainerType m_Running;
+        std::map<std::string, double> m_Metrics;
+    };
+} // namespace itk
+
+#endif //__PerformanceTelemetry_h_
@@ -0,0 +1,123 @@
+#ifndef __QuantileSketch_h_
+#define __QuantileSketch_h_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace itk {
+    /*
+     * Mergeable streaming quantile sketch for non-negative values with a relative accuracy guarantee.
+     *
+     * Values are counted in logarithmic buckets (gamma^(k-1), gamma^k] with gamma = (1 + a) / (1 - a). Quantile()
+     * returns a value within a relative error a of the exact quantile of the inserted values, without storing or
+     * sorting them. Values below MinimumValue are counted in a single zero bucket and reported as 0.
+     *
+     * The memory is bounded by the dynamic range of the values, log(max / MinimumValue) / log(gamma) counters
+     * (about 1400 for 12 decades at 1%), independent of the number of values. Sketches with the same accuracy can
+     * be merged, e.g. one per thread into a single result.
+     */
+    class QuantileSketch {
+    public:
+        typedef std::uint64_t CountType;
+
+        explicit QuantileSketch(double relativeAccuracy = 0.01, double minimumValue = 1e-12)
+                : m_RelativeAccuracy(relativeAccuracy), m_MinimumValue(minimumValue), m_ZeroCount(0), m_Offset(0) {
+            m_Gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+            m_LogGamma = std::log(m_Gamma);
+        }
+
+        double GetRelativeAccuracy() const {
+            return m_RelativeAccuracy;
+        }
+
+        void Insert(double value) {
+            if (!(value >= m_MinimumValue)) {
+                ++m_ZeroCount;
+                return;
+            }
+
+            ++bucket(static_cast<int>(std::ceil(std::log(value) / m_LogGamma)));
+        }
+
+        // add the counts of another sketch with the same relative accuracy
+        void Merge(const QuantileSketch &other) {
+            m_ZeroCount += other.m_ZeroCount;
+            for (size_t i = 0; i < other.m_Counts.size(); ++i) {
+                if (other.m_Counts[i] == 0) {
+                    continue;
+                }
+                bucket(other.m_Offset + static_cast<int>(i)) += other.m_Counts[i];
+            }
+        }
+
+        CountType GetCount() const {
+            CountType count = m_ZeroCount;
+            for (size_t i = 0; i < m_Counts.size(); ++i) {
+                count += m_Counts[i];
+            }
+            return count;
+        }
+
+        // q in [0, 1], the value of rank floor(q * (count - 1)). 0 for an empty sketch.
+        double Quantile(double q) const {
+            const CountType count = GetCount();
+            if (count == 0) {
+                return 0;
+            }
+            q = std::min(1.0, std::max(0.0, q));
+            const CountType rank = static_cast<CountType>(q * (count - 1));
+
+            CountType seen = m_ZeroCount;
+            if (rank < seen) {
+                return 0;
+            }
+            for (size_t i = 0; i < m_Counts.size(); ++i) {
+                seen += m_Counts[i];
+                if (rank < seen) {
+                    // the point of the bucket with the smallest relative distance to both of its bounds
+                    const int key = m_Offset + static_cast<int>(i);
+                    return 2 * std::pow(m_Gamma, key) / (m_Gamma + 1);
+                }
+            }
+            return 2 * std::pow(m_Gamma, m_Offset + static_cast<int>(m_Counts.size()) - 1) / (m_Gamma + 1);
+        }
+
+        // number of bucket counters in use
+        size_t GetNumberOfBuckets() const {
+            return m_Counts.size();
+        }
+
+        void Clear() {
+            m_ZeroCount = 0;
+            m_Counts.clear();
+            m_Offset = 0;
+        }
+
+    private:
+        // counter of bucket key, the range of counters grows to include it
+        CountType &bucket(int key) {
+            if (m_Counts.empty()) {
+                m_Offset = key;
+                m_Counts.push_back(0);
+            } else if (key < m_Offset) {
+                m_Counts.insert(m_Counts.begin(), m_Offset - key, 0);
+                m_Offset = key;
+            } else if (key >= m_Offset + static_cast<int>(m_Counts.size())) {
+                m_Counts.resize(key - m_Offset + 1, 0);
+            }
+            return m_Counts[key - m_Offset];
+        }
+
+        double m_RelativeAccuracy;
+        double m_MinimumValue;
+        double m_Gamma;
+        double m_LogGamma;
+        CountType m_ZeroCount;
+        int m_Offset; // key of m_Counts[0]
+        std::vector<CountType> m_Counts;
+    };
+} // namespace itk
+
+#endif //__QuantileSketch_h_
@@ -0,0 +1,134 @@
+#ifndef __SharedPassHessianRecursiveGaussianImageFilter_h_
+#define __SharedPassHessianRecursiveGaussianImageFilter_h_
+
+#include "itkImageToImageFilter.h"
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkProgressAccumulator.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkNumericTraits.h"
+
+namespace itk {
+    /*
+     * Hessian of an image convolved with a Gaussian, same result as HessianRecursiveGaussianImageFilter.
+     *
+     * HessianRecursiveGaussianImageFilter runs an independent chain of D 1D recursive passes for every one of the
+     * D (D + 1) / 2 tensor components. Here the passes are scheduled as a tree over the derivative orders, from the
+     * last direction to the first, every pass branching into all orders that are left. In 3D, z first, then y,
+     * then x:
+     *
+     *   z: order 0, 1, 2                                   3 passes
+     *   y: order 0..2 on z0, 0..1 on z1, 0 on z2           6 passes
+     *   x: the order that completes a total order of 2     6 passes
+     *
+     * 15 passes in total instead of 18, and only 3 of them run along the strided z direction (6 in the ITK filter).
+     * In 2D it is 3 + 3 passes instead of 6, the same number. The tree is traversed depth first, so at most one
+     * intermediate per level is alive at a time.
+     */
+    template<typename TInputImage, typename TOutputImage = Image<SymmetricSecondRankTensor<
+            typename NumericTraits<typename TInputImage::PixelType>::RealType, TInputImage::ImageDimension>,
+            TInputImage::ImageDimension> >
+    class ITK_EXPORT SharedPassHessianRecursiveGaussianImageFilter : public ImageToImageFilter<TInputImage, TOutputImage> {
+    public:
+        typedef SharedPassHessianRecursiveGaussianImageFilter Self;
+        typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+        typedef SmartPointer<Self> Pointer;
+        typedef SmartPointer<const Self> ConstPointer;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(SharedPassHessianRecursiveGaussianImageFilter, ImageToImageFilter);
+        itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+        typedef TInputImage InputImageType;
+        typedef TOutputImage OutputImageType;
+        typedef typename OutputImageType::PixelType OutputPixelType;
+        typedef typename NumericTraits<OutputPixelType>::ValueType OutputComponentType;
+
+        // intermediates are stored in float like in HessianRecursiveGaussianImageFilter
+        typedef float InternalRealType;
+        typedef Image<InternalRealType, ImageDimension> RealImageType;
+
+        typedef RecursiveGaussianImageFilter<InputImageType, RealImageType> FirstPassFilterType;
+        typedef RecursiveGaussianImageFilter<RealImageType, RealImageType> PassFilterType;
+
+        typedef typename FirstPassFilterType::RealType RealType;
+
+        itkSetMacro(Sigma, RealType);
+        itkGetConstMacro(Sigma, RealType);
+
+        itkSetMacro(NormalizeAcrossScale, bool);
+        itkGetConstMacro(NormalizeAcrossScale, bool);
+        itkBooleanMacro(NormalizeAcrossScale);
+
+        // number of full-volume 1D passes run by the last update, in total or along one direction
+        unsigned int GetNumberOfPasses() const {
+            unsigned int numberOfPasses = 0;
+            for (unsigned int d = 0; d < ImageDimension; ++d) {
+                numberOfPasses += m_NumberOfPasses[d];
+            }
+            return numberOfPasses;
+        }
+
+        unsigned int GetNumberOfPasses(unsigned int direction) const {
+            if (direction >= ImageDimension) {
+                itkExceptionMacro(<< "Direction " << direction << " of an image of dimension " << ImageDimension);
+            }
+            return m_NumberOfPasses[direction];
+        }
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+        itkConceptMacro(InputHasNumericTraitsCheck,
+                (Concept::HasNumericTraits<typename TInputImage::PixelType>));
+#endif
+
+    protected:
+        SharedPassHessianRecursiveGaussianImageFilter();
+
+        virtual ~SharedPassHessianRecursiveGaussianImageFilter() {
+        }
+
+        // the recursive filters need the whole image along every direction
+        void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+        void EnlargeOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
+
+        void GenerateData() ITK_OVERRIDE;
+
+        void PrintSelf(std::ostream &os, Indent indent) const ITK_OVERRIDE;
+
+    private:
+        SharedPassHessianRecursiveGaussianImageFilter(const Self &); //purposely not implemented
+        void operator=(const Self &); //purposely not implemented
+
+        template<typename TFilter>
+        void setUpPass(TFilter *filter, unsigned int direction, unsigned int order);
+
+        // run one 1D pass and count it
+        template<typename TFilter>
+        void runPass(TFilter *filter);
+
+        // number of passes of the subtree below a direction with the order that is left
+        static unsigned int countPasses(unsigned int direction, unsigned int order);
+
+        // the passes along direction with every order up to the one left, each followed by its subtree. orders holds
+        // the orders of the directions above.
+        template<typename TFilter, typename TImage>
+        void passTree(const TImage *image, unsigned int direction, unsigned int order, unsigned int *orders,
+                      ProgressAccumulator *progress, float weight);
+
+        // copy one 1D pass result into a tensor component
+        void copyComponent(const RealImageType *image, unsigned int row, unsigned int column);
+
+        RealType m_Sigma;
+        bool m_NormalizeAcrossScale;
+        unsigned int m_NumberOfPasses[ImageDimension];
+    };
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+
+#include "SharedPassHessianRecursiveGaussianImageFilter.hxx"
+
+#endif
+
+#endif //__SharedPassHessianRecursiveGaussianImageFilter_h_
@@ -0,0 +1,152 @@
+#ifndef __SharedPassHessianRecursiveGaussianImageFilter_hxx_
+#define __SharedPassHessianRecursiveGaussianImageFilter_hxx_
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+#include <algorithm>
+
+namespace itk {
+    template<typename TInputImage, typename TOutputImage>
+    SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::SharedPassHessianRecursiveGaussianImageFilter()
+            : m_Sigma(1.0), m_NormalizeAcrossScale(false) {
+        this->SetNumberOfRequiredInputs(1);
+        std::fill(m_NumberOfPasses, m_NumberOfPasses + ImageDimension, 0u);
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::GenerateInputRequestedRegion() {
+        Superclass::GenerateInputRequestedRegion();
+
+        typename InputImageType::Pointer input = const_cast<InputImageType *>(this->GetInput());
+        if (input) {
+            input->SetRequestedRegionToLargestPossibleRegion();
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::EnlargeOutputRequestedRegion(DataObject *output) {
+        TOutputImage *out = dynamic_cast<TOutputImage *>(output);
+        if (out) {
+            out->SetRequestedRegion(out->GetLargestPossibleRegion());
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    template<typename TFilter>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::setUpPass(TFilter *filter, unsigned int direction, unsigned int order) {
+        filter->SetDirection(direction);
+        filter->SetSigma(m_Sigma);
+        filter->SetNormalizeAcrossScale(m_NormalizeAcrossScale);
+        filter->SetNumberOfThreads(this->GetNumberOfThreads());
+        switch (order) {
+            case 0:
+                filter->SetZeroOrder();
+                break;
+            case 1:
+                filter->SetFirstOrder();
+                break;
+            default:
+                filter->SetSecondOrder();
+                break;
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    template<typename TFilter>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::runPass(TFilter *filter) {
+        filter->Update();
+        ++m_NumberOfPasses[filter->GetDirection()];
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    unsigned int SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::countPasses(unsigned int direction, unsigned int order) {
+        if (direction == 0) {
+            return 1;
+        }
+        unsigned int numberOfPasses = 0;
+        for (unsigned int o = 0; o <= order; ++o) {
+            numberOfPasses += 1 + countPasses(direction - 1, order - o);
+        }
+        return numberOfPasses;
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::GenerateData() {
+        typename OutputImageType::Pointer output = this->GetOutput();
+        output->SetBufferedRegion(output->GetRequestedRegion());
+        output->Allocate();
+
+        // every pass reports the same share of the progress
+        typename ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+        progress->SetMiniPipelineFilter(this);
+        const float weight = 1.0f / countPasses(ImageDimension - 1, 2);
+        std::fill(m_NumberOfPasses, m_NumberOfPasses + ImageDimension, 0u);
+
+        unsigned int orders[ImageDimension];
+        passTree<FirstPassFilterType>(this->GetInput(), ImageDimension - 1, 2, orders, progress, weight);
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    template<typename TFilter, typename TImage>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::passTree(const TImage *image, unsigned int direction, unsigned int order, unsigned int *orders,
+               ProgressAccumulator *progress, float weight) {
+        // the first direction completes the total order of 2, the others branch over every order that is left
+        for (unsigned int o = direction == 0 ? order : 0; o <= order; ++o) {
+            typename TFilter::Pointer filter = TFilter::New();
+            setUpPass(filter.GetPointer(), direction, o);
+            // the input of the last direction has no other consumer, the others are shared by the next branches
+            filter->SetInPlace(direction == 0);
+            filter->SetInput(image);
+            progress->RegisterInternalFilter(filter, weight);
+            runPass(filter.GetPointer());
+            orders[direction] = o;
+
+            if (direction > 0) {
+                passTree<PassFilterType>(filter->GetOutput(), direction - 1, order - o, orders, progress, weight);
+            } else {
+                // the component is the pair of directions with non-zero order, e.g. orderX = 1, orderZ = 1 -> (0, 2)
+                unsigned int directions[2];
+                unsigned int n = 0;
+                for (unsigned int d = 0; d < ImageDimension; ++d) {
+                    for (unsigned int i = 0; i < orders[d]; ++i) {
+                        directions[n++] = d;
+                    }
+                }
+                copyComponent(filter->GetOutput(), directions[0], directions[1]);
+            }
+
+            // release the intermediate before the next branch
+            filter->GetOutput()->ReleaseData();
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::copyComponent(const RealImageType *image, unsigned int row, unsigned int column) {
+        OutputImageType *output = this->GetOutput();
+        ImageRegionConstIterator<RealImageType> it(image, output->GetRequestedRegion());
+        ImageRegionIterator<OutputImageType> ot(output, output->GetRequestedRegion());
+        for (; !it.IsAtEnd(); ++it, ++ot) {
+            ot.Value()(row, column) = static_cast<OutputComponentType>(it.Get());
+        }
+    }
+
+    template<typename TInputImage, typename TOutputImage>
+    void SharedPassHessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>
+    ::PrintSelf(std::ostream &os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Sigma: " << m_Sigma << std::endl;
+        os << indent << "NormalizeAcrossScale: " << m_NormalizeAcrossScale << std::endl;
+    }
+}
+
+#endif // __SharedPassHessianRecursiveGaussianImageFilter_hxx_
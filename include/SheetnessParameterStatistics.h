@@ -0,0 +1,261 @@
+#ifndef __SheetnessParameterStatistics_h_
+#define __SheetnessParameterStatistics_h_
+
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace itk {
+    /*
+     * Statistics of the squared Frobenius norm of the eigenvalues that set C = Scale * sqrt(statistic), shared by
+     * AutomaticSheetnessParameterEstimationImageFilter and EigenAnalysisWithParameterEstimationImageFilter.
+     *
+     * Every thread collects the maximum, the number of voxels in the label and, with a quantile, a QuantileSketch in
+     * its own ThreadStatistics. Merge() reduces the threads and computes C with its error report.
+     *
+     * The voxels are addressed by their offset in the eigenvalue buffer and can be subsampled to about
+     * NumberOfSamples of them: every Stride-th offset, or each offset with probability NumberOfSamples / N. The random
+     * draws are seeded per buffer row, so the sample is the same for every split of the image into threads.
+     */
+    class SheetnessParameterStatistics {
+    public:
+        typedef std::uint64_t CountType;
+        typedef std::ptrdiff_t OffsetType;
+
+        // statistics of one thread
+        struct ThreadStatistics {
+            double Maximum;
+            CountType Count;    // voxels in the label
+            CountType Visited;  // voxels read
+            QuantileSketch *Sketch;
+
+            void Insert(double squaredNorm) {
+                Maximum = std::max(Maximum, squaredNorm);
+                if (Sketch != 0) {
+                    Sketch->Insert(squaredNorm);
+                }
+                ++Count;
+            }
+        };
+
+        SheetnessParameterStatistics()
+                : m_UseQuantile(false), m_RandomSampling(false), m_Seed(0), m_NumberOfPixels(0), m_RowLength(1),
+                  m_Stride(1), m_SamplingProbability(1), m_NumberOfSampledPixels(0), m_NumberOfVisitedPixels(0),
+                  m_C(0), m_CLowerBound(0), m_CUpperBound(0), m_ExceedanceFraction(0) {
+        }
+
+        // Prepare the threads for a buffer of numberOfPixels in rows of rowLength. Every voxel is read for a
+        // numberOfSamples of 0 or not below numberOfPixels.
+        void Initialize(unsigned int numberOfThreads, bool useQuantile, CountType numberOfPixels, CountType rowLength,
+                        CountType numberOfSamples, bool randomSampling, unsigned int seed) {
+            m_UseQuantile = useQuantile;
+            m_RandomSampling = randomSampling;
+            m_Seed = seed;
+            m_NumberOfPixels = numberOfPixels;
+            m_RowLength = std::max<CountType>(rowLength, 1);
+
+            m_Stride = 1;
+            m_SamplingProbability = 1;
+            if (numberOfSamples > 0 && numberOfSamples < numberOfPixels) {
+                m_Stride = numberOfPixels / numberOfSamples;
+                // a stride that shares a factor with the row length would sample the same columns in every row
+                while (greatestCommonDivisor(m_Stride, m_RowLength) != 1) {
+                    ++m_Stride;
+                }
+                m_SamplingProbability = static_cast<double>(numberOfSamples) / numberOfPixels;
+            }
+
+            // the norm is non-negative, 0 is a neutral start
+            ThreadStatistics empty;
+            empty.Maximum = 0;
+            empty.Count = 0;
+            empty.Visited = 0;
+            empty.Sketch = 0;
+            m_Threads.assign(numberOfThreads, empty);
+            // 1% on the squared norm is 0.5% on the norm
+            m_Sketches.assign(useQuantile ? numberOfThreads : 0, QuantileSketch(0.01));
+        }
+
+        // Empty statistics for a thread, inserting into the sketch of the thread. Collect them in a local copy, so
+        // the threads do not write to the same cache lines, and add them back with AddThreadStatistics().
+        ThreadStatistics GetThreadStatistics(unsigned int threadId) {
+            ThreadStatistics statistics;
+            statistics.Maximum = 0;
+            statistics.Count = 0;
+            statistics.Visited = 0;
+            statistics.Sketch = m_UseQuantile ? &m_Sketches[threadId] : 0;
+            return statistics;
+        }
+
+        void AddThreadStatistics(unsigned int threadId, const ThreadStatistics &statistics) {
+            ThreadStatistics &total = m_Threads[threadId];
+            total.Maximum = std::max(total.Maximum, statistics.Maximum);
+            total.Count += statistics.Count;
+            total.Visited += statistics.Visited;
+        }
+
+        // Insert the sampled voxels among the buffer offsets [begin, end), a part of the row starting at rowBegin.
+        // labels may be null, otherwise only the voxels with label are inserted.
+        template <class TEigenValues, class TLabel>
+        void InsertSamples(OffsetType begin, OffsetType end, OffsetType rowBegin, const TEigenValues *eigenValues,
+                           const TLabel *labels, TLabel label, ThreadStatistics &statistics) const {
+            if (!m_RandomSampling || m_SamplingProbability >= 1) {
+                // every m_Stride-th voxel of the buffer, every voxel without sampling
+                const OffsetType stride = static_cast<OffsetType>(m_Stride);
+                for (OffsetType offset = (begin + stride - 1) / stride * stride; offset < end; offset += stride) {
+                    insert(offset, eigenValues, labels, label, statistics);
+                }
+                return;
+            }
+
+            // Bernoulli sampling by geometric skips, the generator is seeded per row
+            std::uint64_t state = (static_cast<std::uint64_t>(m_Seed) << 32) ^
+                                  static_cast<std::uint64_t>(rowBegin / static_cast<OffsetType>(m_RowLength));
+            const double logKeep = std::log(1 - m_SamplingProbability);
+            OffsetType offset = rowBegin - 1;
+            while (true) {
+                // uniform in (0, 1]
+                const double u = ((nextRandom(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+                offset += 1 + static_cast<OffsetType>(std::floor(std::log(u) / logKeep));
+                if (offset >= end) {
+                    break;
+                }
+                if (offset >= begin) {
+                    insert(offset, eigenValues, labels, label, statistics);
+                }
+            }
+        }
+
+        // Reduce the threads and set C with its error report
+        void Merge(double scale, double quantile) {
+            double maximum = 0;
+            m_NumberOfSampledPixels = 0;
+            m_NumberOfVisitedPixels = 0;
+            for (size_t i = 0; i < m_Threads.size(); ++i) {
+                maximum = std::max(maximum, m_Threads[i].Maximum);
+                m_NumberOfSampledPixels += m_Threads[i].Count;
+                m_NumberOfVisitedPixels += m_Threads[i].Visited;
+            }
+
+            const bool sampled = m_NumberOfVisitedPixels < m_NumberOfPixels;
+            if (m_UseQuantile) {
+                QuantileSketch sketch(0.01);
+                for (size_t i = 0; i < m_Sketches.size(); ++i) {
+                    sketch.Merge(m_Sketches[i]);
+                }
+                m_Sketches.clear();
+                m_C = scale * std::sqrt(sketch.Quantile(quantile));
+
+                // the rank of the quantile in a sample of n is binomial, the normal approximation gives the interval
+                m_CLowerBound = m_C;
+                m_CUpperBound = m_C;
+                if (sampled && m_NumberOfSampledPixels > 0) {
+                    const double halfWidth = 1.96 * std::sqrt(quantile * (1 - quantile) / m_NumberOfSampledPixels);
+                    m_CLowerBound = scale * std::sqrt(sketch.Quantile(quantile - halfWidth));
+                    m_CUpperBound = scale * std::sqrt(sketch.Quantile(quantile + halfWidth));
+                }
+                m_ExceedanceFraction = 1 - quantile;
+            } else {
+                m_C = scale * std::sqrt(maximum);
+
+                // the maximum of a sample is a lower bound, on average 1 / (n + 1) of the population lies above it
+                m_CLowerBound = m_C;
+                m_CUpperBound = m_C;
+                m_ExceedanceFraction = sampled ? 1.0 / (m_NumberOfSampledPixels + 1) : 0.0;
+            }
+        }
+
+        template <class TEigenValues>
+        static double SquaredNorm(const TEigenValues &eigenValues) {
+            double norm = 0;
+            for (unsigned int i = 0; i < eigenValues.Size(); ++i) {
+                norm += static_cast<double>(eigenValues[i] * eigenValues[i]);
+            }
+            return norm;
+        }
+
+        unsigned int GetNumberOfThreads() const {
+            return static_cast<unsigned int>(m_Threads.size());
+        }
+
+        // Results of the last Merge()
+        CountType GetNumberOfSampledPixels() const {
+            return m_NumberOfSampledPixels;
+        }
+
+        CountType GetNumberOfVisitedPixels() const {
+            return m_NumberOfVisitedPixels;
+        }
+
+        double GetC() const {
+            return m_C;
+        }
+
+        double GetCLowerBound() const {
+            return m_CLowerBound;
+        }
+
+        double GetCUpperBound() const {
+            return m_CUpperBound;
+        }
+
+        double GetExceedanceFraction() const {
+            return m_ExceedanceFraction;
+        }
+
+    private:
+        template <class TEigenValues, class TLabel>
+        static void insert(OffsetType offset, const TEigenValues *eigenValues, const TLabel *labels, TLabel label,
+                           ThreadStatistics &statistics) {
+            ++statistics.Visited;
+            if (labels != 0 && labels[offset] != label) {
+                return;
+            }
+            statistics.Insert(SquaredNorm(eigenValues[offset]));
+        }
+
+        // splitmix64, a small deterministic generator for the random sampling
+        static std::uint64_t nextRandom(std::uint64_t &state) {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        static CountType greatestCommonDivisor(CountType a, CountType b) {
+            while (b != 0) {
+                const CountType r = a % b;
+                a = b;
+                b = r;
+            }
+            return a;
+        }
+
+        // sampling
+        bool m_UseQuantile;
+        bool m_RandomSampling;
+        unsigned int m_Seed;
+        CountType m_NumberOfPixels;
+        CountType m_RowLength;
+        CountType m_Stride;
+        double m_SamplingProbability;
+
+        // per thread
+        std::vector<ThreadStatistics> m_Threads;
+        std::vector<QuantileSketch> m_Sketches;
+
+        // results
+        CountType m_NumberOfSampledPixels;
+        CountType m_NumberOfVisitedPixels;
+        double m_C;
+        double m_CLowerBound;
+        double m_CUpperBound;
+        double m_ExceedanceFraction;
+    };
+} // namespace itk
+
+#endif //__SheetnessParameterStatistics_h_
@@ -0,0 +1,237 @@
+#ifndef _TiledSheetnessImageFilter_hxx_
+#define _TiledSheetnessImageFilter_hxx_
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "vnl/vnl_math.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::TiledSheetnessImageFilter()
+        : m_Sigma(1.0), m_Alpha(0.5), m_Scale(0.05), m_UseQuantile(false), m_Quantile(0.99), m_C(0.0),
+        m_DetectBrightSheets(true),
+        m_UseFastExp(false), m_HaloSigmas(6.0), m_Label(1), m_NumberOfTiles(0), m_NextTile(0)
+    {
+        this->SetNumberOfRequiredInputs(1);
+        m_TileSize.Fill(32);
+        m_EigenAnalysisFunctor.SetDimension(ImageDimension);
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::GenerateInputRequestedRegion() {
+        Superclass::GenerateInputRequestedRegion();
+
+        InputImageType *input = const_cast<InputImageType *>(this->GetInput());
+        if (input) {
+            input->SetRequestedRegionToLargestPossibleRegion();
+        }
+        LabelImageType *label = const_cast<LabelImageType *>(this->GetLabelInput());
+        if (label) {
+            label->SetRequestedRegionToLargestPossibleRegion();
+        }
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::EnlargeOutputRequestedRegion(DataObject *data) {
+        Superclass::EnlargeOutputRequestedRegion(data);
+        data->SetRequestedRegionToLargestPossibleRegion();
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::GenerateData() {
+        this->AllocateOutputs();
+
+        // cut the output into tiles, the last tile along a direction may be smaller
+        const RegionType region = this->GetOutput()->GetRequestedRegion();
+        m_Tiles.clear();
+        SizeType numberOfTiles;
+        for (unsigned int d = 0; d < ImageDimension; ++d) {
+            if (m_TileSize[d] == 0) {
+                itkExceptionMacro(<< "TileSize has to be positive");
+            }
+            numberOfTiles[d] = (region.GetSize(d) + m_TileSize[d] - 1) / m_TileSize[d];
+        }
+        typename RegionType::IndexType tileIndex;
+        tileIndex.Fill(0);
+        while (numberOfTiles[ImageDimension - 1] > 0
+               && static_cast<SizeValueType>(tileIndex[ImageDimension - 1]) < numberOfTiles[ImageDimension - 1]) {
+            RegionType tile;
+            for (unsigned int d = 0; d < ImageDimension; ++d) {
+                const IndexValueType start = region.GetIndex(d) + tileIndex[d] * m_TileSize[d];
+                tile.SetIndex(d, start);
+                tile.SetSize(d, std::min<SizeValueType>(m_TileSize[d], region.GetIndex(d) + region.GetSize(d) - start));
+            }
+            m_Tiles.push_back(tile);
+
+            // next tile, x fastest
+            for (unsigned int d = 0; d < ImageDimension; ++d) {
+                if (static_cast<SizeValueType>(++tileIndex[d]) < numberOfTiles[d] || d == ImageDimension - 1) {
+                    break;
+                }
+                tileIndex[d] = 0;
+            }
+        }
+        m_NumberOfTiles = m_Tiles.size();
+
+        // pass 1, statistics of the norm, every voxel is read
+        const LabelImageType *label = this->GetLabelInput();
+        if (label != ITK_NULLPTR && !label->GetBufferedRegion().IsInside(region)) {
+            itkExceptionMacro(<< "The label image has to cover the output region");
+        }
+        m_Statistics.Initialize(this->GetNumberOfThreads(), m_UseQuantile, region.GetNumberOfPixels(),
+                                region.GetSize(0), 0, false, 0);
+        runPass(1);
+        m_Statistics.Merge(m_Scale, m_Quantile);
+        m_C = m_Statistics.GetC();
+        if (label != ITK_NULLPTR && m_Statistics.GetNumberOfSampledPixels() == 0) {
+            itkWarningMacro(<< "No voxel with label " << static_cast<double>(m_Label) << ", C is set to 0");
+        }
+
+        // pass 2, sheetness
+        runPass(2);
+        m_Tiles.clear();
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::runPass(unsigned int pass) {
+        TileThreadStruct data;
+        data.Filter = this;
+        data.Pass = pass;
+        m_NextTile = 0;
+
+        typename MultiThreader::Pointer threader = this->GetMultiThreader();
+        threader->SetNumberOfThreads(this->GetNumberOfThreads());
+        threader->SetSingleMethod(Self::tileThreaderCallback, &data);
+        threader->SingleMethodExecute();
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    ITK_THREAD_RETURN_TYPE TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::tileThreaderCallback(void *arg) {
+        MultiThreader::ThreadInfoStruct *info = static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+        TileThreadStruct *data = static_cast<TileThreadStruct *>(info->UserData);
+        data->Filter->processTiles(data->Pass, info->ThreadID);
+        return ITK_THREAD_RETURN_VALUE;
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::processTiles(unsigned int pass, ThreadIdType threadId) {
+        // the statistics are only collected in pass 1
+        SheetnessParameterStatistics::ThreadStatistics statistics;
+        if (pass == 1) {
+            statistics = m_Statistics.GetThreadStatistics(threadId);
+        }
+        for (size_t i = m_NextTile++; i < m_Tiles.size(); i = m_NextTile++) {
+            processTile(m_Tiles[i], pass, statistics);
+        }
+        if (pass == 1) {
+            m_Statistics.AddThreadStatistics(threadId, statistics);
+        }
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::processTile(const RegionType &tile, unsigned int pass, SheetnessParameterStatistics::ThreadStatistics &statistics) {
+        const InputImageType *input = this->GetInput();
+
+        // tile with its halo, clipped to the image
+        RegionType haloRegion = tile;
+        typename RegionType::SizeType radius;
+        // at least 3 voxels, so a 1 voxel tile at the image border still has the 4 the recursive Gaussian needs
+        for (unsigned int d = 0; d < ImageDimension; ++d) {
+            radius[d] = std::max<SizeValueType>(3, static_cast<SizeValueType>(
+                    std::ceil(m_HaloSigmas * m_Sigma / input->GetSpacing()[d])));
+        }
+        haloRegion.PadByRadius(radius);
+        haloRegion.Crop(input->GetLargestPossibleRegion());
+
+        // the tile gets its own copy of the input, no pipeline is run on the shared input
+        typename InputImageType::Pointer tileImage = InputImageType::New();
+        tileImage->CopyInformation(input);
+        tileImage->SetRegions(haloRegion);
+        tileImage->Allocate();
+        ImageRegionConstIterator<InputImageType> it(input, haloRegion);
+        ImageRegionIterator<InputImageType> tt(tileImage, haloRegion);
+        for (; !it.IsAtEnd(); ++it, ++tt) {
+            tt.Set(it.Get());
+        }
+
+        typename HessianFilterType::Pointer hessian = HessianFilterType::New();
+        hessian->SetInput(tileImage);
+        hessian->SetSigma(m_Sigma);
+        hessian->SetNumberOfThreads(1); // the threads work on different tiles
+        hessian->Update();
+
+        ImageRegionConstIterator<HessianImageType> ht(hessian->GetOutput(), tile);
+        if (pass == 1) {
+            const LabelImageType *label = this->GetLabelInput();
+            ImageRegionConstIterator<LabelImageType> lt;
+            if (label != ITK_NULLPTR) {
+                lt = ImageRegionConstIterator<LabelImageType>(label, tile);
+            }
+            statistics.Visited += tile.GetNumberOfPixels();
+            for (; !ht.IsAtEnd(); ++ht) {
+                if (label != ITK_NULLPTR) {
+                    const bool inside = lt.Get() == m_Label;
+                    ++lt;
+                    if (!inside) {
+                        continue;
+                    }
+                }
+                // ||H||_F^2 = sum of the squared eigenvalues, off-diagonal elements count twice
+                const HessianPixelType &hessian = ht.Get();
+                double norm = 0;
+                for (unsigned int r = 0; r < ImageDimension; ++r) {
+                    norm += hessian(r, r) * hessian(r, r);
+                    for (unsigned int c = r + 1; c < ImageDimension; ++c) {
+                        norm += 2 * hessian(r, c) * hessian(r, c);
+                    }
+                }
+                statistics.Insert(norm);
+            }
+        } else {
+            SheetnessFunctorType sheetness;
+            sheetness.SetAlpha(m_Alpha);
+            sheetness.SetC(m_C);
+            sheetness.SetUseFastExp(m_UseFastExp);
+            if (m_DetectBrightSheets) {
+                sheetness.DetectBrightSheetsOn();
+            } else {
+                sheetness.DetectDarkSheetsOn();
+            }
+            ImageRegionIterator<OutputImageType> ot(this->GetOutput(), tile);
+            for (; !ht.IsAtEnd(); ++ht, ++ot) {
+                ot.Set(sheetness(m_EigenAnalysisFunctor(ht.Get())));
+            }
+        }
+    }
+
+    template <class TInputImage, class TOutputImage, class TLabelImage>
+    void TiledSheetnessImageFilter<TInputImage, TOutputImage, TLabelImage>
+    ::PrintSelf(std::ostream & os, Indent indent) const {
+        Superclass::PrintSelf(os, indent);
+        os << indent << "Sigma: " << m_Sigma << std::endl;
+        os << indent << "Alpha: " << m_Alpha << std::endl;
+        os << indent << "Scale: " << m_Scale << std::endl;
+        os << indent << "UseQuantile: " << m_UseQuantile << std::endl;
+        os << indent << "Quantile: " << m_Quantile << std::endl;
+        os << indent << "C: " << m_C << std::endl;
+        os << indent << "DetectBrightSheets: " << m_DetectBrightSheets << std::endl;
+        os << indent << "UseFastExp: " << m_UseFastExp << std::endl;
+        os << indent << "TileSize: " << m_TileSize << std::endl;
+        os << indent << "HaloSigmas: " << m_HaloSigmas << std::endl;
+        os << indent << "Label: " << static_cast<double>(m_Label) << std::endl;
+        os << indent << "NumberOfTiles: " << m_NumberOfTiles << std::endl;
+    }
+}
+
+#endif /* _TiledSheetnessImageFilter_hxx_ */
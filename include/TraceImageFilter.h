@@ -2,62 +2,54 @@
 #define __TraceImageFilter_h_
 
 #include "itkUnaryFunctorImageFilter.h"
+#include "DynamicThreadedImageFilter.h"
 
 namespace itk {
     /**
     * This functor calculates the trace tr(A) which is defined as the sum of all elements
     * on the main diagonal of matrix A. tr(A) = a11+a22+...+ann
+    *
+    * n is the template parameter VDimension, by default the dimension of the tensor, so the loop has a constant
+    * trip count and is unrolled by the compiler.
     */
     namespace Functor {
-        template<class TInput, class TOutput>
+        template<class TInput, class TOutput, unsigned int VDimension = TInput::Dimension>
         class Trace {
         public:
-            Trace() : m_Dimension(0) {
+            Trace() {
             };
 
             ~Trace() {
             };
 
-            inline TOutput operator()(const TInput &A) {
+            inline TOutput operator()(const TInput &A) const {
                 TOutput sum = 0.0;
-                for (unsigned int index = 0; index < m_Dimension; index++) {
+                for (unsigned int index = 0; index < VDimension; index++) {
                     sum += A(index, index);
                 }
                 return sum;
             }
-
-            void SetImageDimension(unsigned int n) {
-                m_Dimension = n;
-            }
-
-        protected:
-            unsigned int m_Dimension;
         };
     } // end namespace functor
 
     template<typename TInputImage, typename TOutputImage = TInputImage>
-    class TraceImageFilter : public UnaryFunctorImageFilter<
+    class TraceImageFilter : public DynamicThreadedImageFilter<UnaryFunctorImageFilter<
             TInputImage,
             TOutputImage,
-            Functor::Trace<typename TInputImage::PixelType, typename TOutputImage::PixelType> > {
+            Functor::Trace<typename TInputImage::PixelType, typename TOutputImage::PixelType> > > {
     public:
         // itk requirements
         typedef TraceImageFilter Self;
-        typedef UnaryFunctorImageFilter<
+        typedef DynamicThreadedImageFilter<UnaryFunctorImageFilter<
                 TInputImage,
                 TOutputImage,
-                Functor::Trace<typename TInputImage::PixelType, typename TOutputImage::PixelType> > Superclass;
+                Functor::Trace<typename TInputImage::PixelType, typename TOutputImage::PixelType> > > Superclass;
         typedef SmartPointer<Self> Pointer;
         typedef SmartPointer<const Self> ConstPointer;
 
         itkNewMacro(Self); // create the smart pointers and register with ITKs object factory
         itkTypeMacro(TraceImageFilter, UnaryFunctorImageFilter); // type information for runtime evaluation
 
-        // member functions
-        void SetImageDimension(unsigned int n) {
-            this->GetFunctor().SetImageDimension(n);
-        }
-
 #ifdef ITK_USE_CONCEPT_CHECKING
         // input is numeric
         itkConceptMacro(InputHasNumericTraitsCheck,
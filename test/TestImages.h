@@ -0,0 +1,82 @@
+#ifndef __TestImages_h_
+#define __TestImages_h_
+
+#include "itkImageRegionIterator.h"
+
+#include <random>
+
+/*
+ * Seeded random images shared by the unit tests. The values are drawn in the order of an ImageRegionIterator, so
+ * the same size and seed give the same image on every platform.
+ */
+namespace TestImages {
+    // scalar values uniform in [-range, range)
+    template<typename TImage>
+    typename TImage::Pointer createRandomImage(const typename TImage::SizeType &size, unsigned int seed,
+                                               double range) {
+        typedef typename TImage::PixelType PixelType;
+
+        typename TImage::Pointer image = TImage::New();
+        image->SetRegions(size);
+        image->Allocate();
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<PixelType> value(-range, range);
+        itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion());
+        for (; !it.IsAtEnd(); ++it) {
+            it.Set(value(generator));
+        }
+        return image;
+    }
+
+    // eigenvalue arrays with components uniform in [-range, range). With a zeroModulus above 0 every
+    // zeroModulus-th voxel, counted from the first, is all zeros and takes no draws.
+    template<typename TImage>
+    typename TImage::Pointer createRandomEigenValues(const typename TImage::SizeType &size, unsigned int seed,
+                                                     double range, unsigned int zeroModulus = 0) {
+        typedef typename TImage::PixelType EigenValueArrayType;
+        typedef typename EigenValueArrayType::ValueType ValueType;
+
+        typename TImage::Pointer image = TImage::New();
+        image->SetRegions(size);
+        image->Allocate();
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<ValueType> value(-range, range);
+        itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion());
+        for (unsigned int i = 0; !it.IsAtEnd(); ++it, ++i) {
+            EigenValueArrayType eigenValues;
+            for (unsigned int j = 0; j < EigenValueArrayType::Dimension; ++j) {
+                eigenValues[j] = zeroModulus > 0 && i % zeroModulus == 0 ? ValueType() : value(generator);
+            }
+            it.Set(eigenValues);
+        }
+        return image;
+    }
+
+    // symmetric tensors with every independent element uniform in [-range, range)
+    template<typename TImage>
+    typename TImage::Pointer createRandomHessian(const typename TImage::SizeType &size, unsigned int seed,
+                                                 double range) {
+        typedef typename TImage::PixelType HessianPixelType;
+        typedef typename HessianPixelType::ValueType ValueType;
+
+        typename TImage::Pointer image = TImage::New();
+        image->SetRegions(size);
+        image->Allocate();
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<ValueType> value(-range, range);
+        itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion());
+        for (; !it.IsAtEnd(); ++it) {
+            HessianPixelType hessian;
+            for (unsigned int i = 0; i < HessianPixelType::InternalDimension; ++i) {
+                hessian[i] = value(generator);
+            }
+            it.Set(hessian);
+        }
+        return image;
+    }
+} // namespace TestImages
+
+#endif // __TestImages_h_
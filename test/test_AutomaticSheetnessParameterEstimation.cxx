@@ -0,0 +1,202 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkStatisticsImageFilter.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "FrobeniusNormImageFilter.h"
+#include "AutomaticSheetnessParameterEstimationImageFilter.h"
+#include "TestImages.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+typedef itk::FixedArray<double, 3> EigenValueArrayType;
+typedef itk::Image<EigenValueArrayType, 3> EigenValueImageType;
+typedef itk::Image<unsigned char, 3> MaskImageType;
+typedef itk::Image<double, 3> NormImageType;
+typedef itk::AutomaticSheetnessParameterEstimationImageFilter<EigenValueImageType, MaskImageType> EstimationFilterType;
+typedef itk::FrobeniusNormImageFilter<EigenValueImageType, NormImageType> FrobeniusNormFilterType;
+
+EigenValueImageType::Pointer createEigenValues() {
+    EigenValueImageType::SizeType size = {{19, 23, 17}};
+    return TestImages::createRandomEigenValues<EigenValueImageType>(size, 3, 400);
+}
+
+// label 1 in a box, 2 elsewhere
+MaskImageType::Pointer createMask(const EigenValueImageType *image) {
+    MaskImageType::Pointer mask = MaskImageType::New();
+    mask->SetRegions(image->GetLargestPossibleRegion());
+    mask->Allocate();
+    itk::ImageRegionIterator<MaskImageType> it(mask, mask->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        const MaskImageType::IndexType idx = it.GetIndex();
+        it.Set(idx[0] > 4 && idx[0] < 12 && idx[1] > 6 && idx[2] < 9 ? 1 : 2);
+    }
+    return mask;
+}
+
+TEST(AutomaticSheetnessParameterEstimationImageFilter, MatchesStatisticsOfFrobeniusNorm) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+
+    FrobeniusNormFilterType::Pointer norm = FrobeniusNormFilterType::New();
+    norm->SetInput(eigenValues);
+    typedef itk::StatisticsImageFilter<NormImageType> StatisticsFilterType;
+    StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+    statistics->SetInput(norm->GetOutput());
+    statistics->Update();
+
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigenValues);
+    estimation->SetScale(0.25);
+    estimation->Update();
+
+    EXPECT_NEAR(0.25 * statistics->GetMaximum(), estimation->GetC(), 1e-9 * statistics->GetMaximum());
+    // the input is passed through
+    EXPECT_EQ(eigenValues->GetBufferPointer(), estimation->GetOutput()->GetBufferPointer());
+}
+
+TEST(AutomaticSheetnessParameterEstimationImageFilter, MatchesLabelStatisticsOfFrobeniusNorm) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+    MaskImageType::Pointer mask = createMask(eigenValues);
+
+    FrobeniusNormFilterType::Pointer norm = FrobeniusNormFilterType::New();
+    norm->SetInput(eigenValues);
+    typedef itk::LabelStatisticsImageFilter<NormImageType, MaskImageType> LabelStatisticsFilterType;
+    LabelStatisticsFilterType::Pointer statistics = LabelStatisticsFilterType::New();
+    statistics->SetInput(norm->GetOutput());
+    statistics->SetLabelInput(mask);
+    statistics->Update();
+
+    for (unsigned char label = 1; label <= 2; ++label) {
+        EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+        estimation->SetInput(eigenValues);
+        estimation->SetLabelInput(mask);
+        estimation->SetLabel(label);
+        estimation->SetScale(0.1);
+        estimation->Update();
+
+        const double maximum = statistics->GetMaximum(label);
+        EXPECT_NEAR(0.1 * maximum, estimation->GetC(), 1e-9 * maximum) << "label " << static_cast<int>(label);
+    }
+}
+
+TEST(AutomaticSheetnessParameterEstimationImageFilter, QuantileWithinLabel) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+    MaskImageType::Pointer mask = createMask(eigenValues);
+
+    // a single outlier inside the label
+    EigenValueImageType::IndexType outlier = {{8, 10, 4}};
+    EigenValueArrayType implant;
+    implant.Fill(1e6);
+    eigenValues->SetPixel(outlier, implant);
+
+    // exact quantile of the norms with label 1
+    std::vector<double> norms;
+    itk::ImageRegionIterator<EigenValueImageType> it(eigenValues, eigenValues->GetBufferedRegion());
+    itk::ImageRegionIterator<MaskImageType> mt(mask, mask->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it, ++mt) {
+        if (mt.Get() == 1) {
+            const EigenValueArrayType value = it.Get();
+            norms.push_back(std::sqrt(value[0] * value[0] + value[1] * value[1] + value[2] * value[2]));
+        }
+    }
+    std::sort(norms.begin(), norms.end());
+    const double exact = norms[static_cast<size_t>(0.95 * (norms.size() - 1))];
+
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigenValues);
+    estimation->SetLabelInput(mask);
+    estimation->SetLabel(1);
+    estimation->SetScale(1.0);
+    estimation->UseQuantileOn();
+    estimation->SetQuantile(0.95);
+    estimation->Update();
+
+    EXPECT_NEAR(exact, estimation->GetC(), 0.005 * exact);
+    EXPECT_LT(estimation->GetC(), 1000.0);
+}
+
+double estimateSampledQuantile(EigenValueImageType *eigenValues, EstimationFilterType::SamplingModeType mode,
+                               unsigned int numberOfThreads, EstimationFilterType::Pointer &estimation) {
+    estimation = EstimationFilterType::New();
+    estimation->SetInput(eigenValues);
+    estimation->SetScale(1.0);
+    estimation->UseQuantileOn();
+    estimation->SetQuantile(0.9);
+    estimation->SetSamplingMode(mode);
+    estimation->SetNumberOfSamples(1000);
+    estimation->SetSeed(17);
+    estimation->SetNumberOfThreads(numberOfThreads);
+    estimation->Update();
+    return estimation->GetC();
+}
+
+TEST(AutomaticSheetnessParameterEstimationImageFilter, SubsampledQuantile) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+    const itk::SizeValueType numberOfPixels = eigenValues->GetBufferedRegion().GetNumberOfPixels();
+
+    EstimationFilterType::Pointer full = EstimationFilterType::New();
+    full->SetInput(eigenValues);
+    full->SetScale(1.0);
+    full->UseQuantileOn();
+    full->SetQuantile(0.9);
+    full->Update();
+    EXPECT_EQ(numberOfPixels, full->GetNumberOfSampledPixels());
+    EXPECT_EQ(full->GetC(), full->GetCLowerBound());
+    EXPECT_EQ(full->GetC(), full->GetCUpperBound());
+
+    const EstimationFilterType::SamplingModeType modes[] = {EstimationFilterType::StrideSampling,
+                                                             EstimationFilterType::RandomSampling};
+    for (unsigned int i = 0; i < 2; ++i) {
+        EstimationFilterType::Pointer sampled;
+        const double c = estimateSampledQuantile(eigenValues, modes[i], 4, sampled);
+
+        EXPECT_GT(sampled->GetNumberOfSampledPixels(), 500u) << "mode " << modes[i];
+        EXPECT_LT(sampled->GetNumberOfSampledPixels(), 2000u) << "mode " << modes[i];
+        EXPECT_LE(sampled->GetCLowerBound(), c);
+        EXPECT_GE(sampled->GetCUpperBound(), c);
+        // the interval covers the full estimate, widened by the sketch accuracy
+        EXPECT_LE(sampled->GetCLowerBound(), 1.01 * full->GetC()) << "mode " << modes[i];
+        EXPECT_GE(sampled->GetCUpperBound(), 0.99 * full->GetC()) << "mode " << modes[i];
+
+        // the sample does not depend on the number of threads
+        EstimationFilterType::Pointer singleThreaded;
+        EXPECT_EQ(c, estimateSampledQuantile(eigenValues, modes[i], 1, singleThreaded)) << "mode " << modes[i];
+    }
+}
+
+TEST(AutomaticSheetnessParameterEstimationImageFilter, SubsampledMaximum) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+
+    EstimationFilterType::Pointer full = EstimationFilterType::New();
+    full->SetInput(eigenValues);
+    full->Update();
+    EXPECT_EQ(0.0, full->GetExceedanceFraction());
+
+    EstimationFilterType::Pointer sampled = EstimationFilterType::New();
+    sampled->SetInput(eigenValues);
+    sampled->SetSamplingMode(EstimationFilterType::RandomSampling);
+    sampled->SetNumberOfSamples(2000);
+    sampled->Update();
+
+    EXPECT_LE(sampled->GetC(), full->GetC());
+    EXPECT_GT(sampled->GetC(), 0.9 * full->GetC());
+    EXPECT_DOUBLE_EQ(1.0 / (sampled->GetNumberOfSampledPixels() + 1), sampled->GetExceedanceFraction());
+}
+
+TEST(AutomaticSheetnessParameterEstimationImageFilter, MissingLabel) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+    MaskImageType::Pointer mask = createMask(eigenValues);
+
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigenValues);
+    estimation->SetLabelInput(mask);
+    estimation->SetLabel(7);
+    itk::Object::GlobalWarningDisplayOff();
+    estimation->Update();
+
+    EXPECT_EQ(0.0, estimation->GetC());
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkAddImageFilter.h"
+#include "BroadcastingBinaryFunctorImageFilter.h"
+#include "TestImages.h"
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::Functor::Add2<float, float, float> FunctorType;
+typedef itk::BroadcastingBinaryFunctorImageFilter<ImageType, ImageType, ImageType, FunctorType> FilterType;
+
+ImageType::Pointer createImage(const ImageType::SizeType &size, unsigned int seed) {
+    return TestImages::createRandomImage<ImageType>(size, seed, 100);
+}
+
+// input2 has size 1 along the axes of broadcast
+void compareWithReference(const FilterType::BroadcastAxesType &broadcast, bool setAxes) {
+    ImageType::SizeType size1 = {{23, 17, 9}};
+    ImageType::SizeType size2 = size1;
+    for (unsigned int d = 0; d < 3; ++d) {
+        if (broadcast[d]) {
+            size2[d] = 1;
+        }
+    }
+    ImageType::Pointer image1 = createImage(size1, 1);
+    ImageType::Pointer image2 = createImage(size2, 2);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput1(image1);
+    filter->SetInput2(image2);
+    if (setAxes) {
+        filter->SetBroadcastAxes(broadcast);
+    }
+    filter->Update();
+    EXPECT_EQ(broadcast, filter->GetBroadcastAxes());
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> it(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        ImageType::IndexType index2 = it.GetIndex();
+        for (unsigned int d = 0; d < 3; ++d) {
+            if (broadcast[d]) {
+                index2[d] = 0;
+            }
+        }
+        ASSERT_EQ(image1->GetPixel(it.GetIndex()) + image2->GetPixel(index2), it.Get()) << "at " << it.GetIndex();
+    }
+}
+
+FilterType::BroadcastAxesType axes(bool x, bool y, bool z) {
+    FilterType::BroadcastAxesType broadcast;
+    broadcast[0] = x;
+    broadcast[1] = y;
+    broadcast[2] = z;
+    return broadcast;
+}
+
+TEST(BroadcastingBinaryFunctorImageFilter, BroadcastAlongZ) {
+    compareWithReference(axes(false, false, true), false);
+    compareWithReference(axes(false, false, true), true);
+}
+
+TEST(BroadcastingBinaryFunctorImageFilter, BroadcastAlongY) {
+    compareWithReference(axes(false, true, false), false);
+}
+
+TEST(BroadcastingBinaryFunctorImageFilter, BroadcastAlongX) {
+    compareWithReference(axes(true, false, false), false);
+}
+
+TEST(BroadcastingBinaryFunctorImageFilter, BroadcastAlongSeveralAxes) {
+    compareWithReference(axes(true, false, true), false);
+    compareWithReference(axes(false, true, true), true);
+    compareWithReference(axes(true, true, true), false);
+}
+
+TEST(BroadcastingBinaryFunctorImageFilter, SameSize) {
+    compareWithReference(axes(false, false, false), false);
+}
+
+TEST(BroadcastingBinaryFunctorImageFilter, MismatchThrows) {
+    ImageType::SizeType size1 = {{23, 17, 9}};
+    ImageType::SizeType size2 = {{23, 16, 1}};
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput1(createImage(size1, 1));
+    filter->SetInput2(createImage(size2, 2));
+    EXPECT_THROW(filter->Update(), itk::ExceptionObject);
+}
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "DiscreteHessianImageFilter.h"
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::DiscreteHessianImageFilter<ImageType> FilterType;
+
+// central differences are exact for a quadratic, f = x^T A x / 2 has the Hessian A
+TEST(DiscreteHessianImageFilter, ExactForQuadratic) {
+    const double A[3][3] = {{2.0, 0.5, -1.0},
+                            {0.5, -3.0, 0.25},
+                            {-1.0, 0.25, 1.5}};
+
+    ImageType::Pointer image = ImageType::New();
+    ImageType::SizeType size = {{11, 9, 7}};
+    image->SetRegions(size);
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.5;
+    spacing[1] = 1.0;
+    spacing[2] = 2.0;
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        double x[3];
+        for (unsigned int d = 0; d < 3; ++d) {
+            x[d] = (it.GetIndex()[d] - 4.0) * spacing[d];
+        }
+        double f = 0;
+        for (unsigned int d = 0; d < 3; ++d) {
+            for (unsigned int e = 0; e < 3; ++e) {
+                f += 0.5 * x[d] * A[d][e] * x[e];
+            }
+        }
+        it.Set(f);
+    }
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->Update();
+
+    // away from the boundary, where the zero flux extension breaks the quadratic
+    ImageType::RegionType interior = image->GetBufferedRegion();
+    interior.ShrinkByRadius(1);
+    itk::ImageRegionConstIteratorWithIndex<FilterType::OutputImageType> ht(filter->GetOutput(), interior);
+    for (; !ht.IsAtEnd(); ++ht) {
+        for (unsigned int d = 0; d < 3; ++d) {
+            for (unsigned int e = 0; e < 3; ++e) {
+                ASSERT_NEAR(A[d][e], ht.Get()(d, e), 1e-3) << "component (" << d << "," << e << ") at " << ht.GetIndex();
+            }
+        }
+    }
+}
+
+TEST(DiscreteHessianImageFilter, ConstantImageAtTheBoundary) {
+    ImageType::Pointer image = ImageType::New();
+    ImageType::SizeType size = {{5, 4, 3}};
+    image->SetRegions(size);
+    image->Allocate();
+    image->FillBuffer(7);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->Update();
+
+    itk::ImageRegionConstIteratorWithIndex<FilterType::OutputImageType> ht(filter->GetOutput(),
+                                                                          filter->GetOutput()->GetBufferedRegion());
+    for (; !ht.IsAtEnd(); ++ht) {
+        for (unsigned int d = 0; d < 3; ++d) {
+            for (unsigned int e = 0; e < 3; ++e) {
+                ASSERT_EQ(0, ht.Get()(d, e)) << "at " << ht.GetIndex();
+            }
+        }
+    }
+}
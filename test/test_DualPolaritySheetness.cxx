@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "ModifiedSheetnessImageFilter.h"
+#include "KrcahSheetnessImageFilter.h"
+#include "DualPolarityModifiedSheetnessImageFilter.h"
+#include "DualPolarityKrcahSheetnessImageFilter.h"
+#include "TestImages.h"
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::FixedArray<double, 3> EigenValueArrayType;
+typedef itk::Image<EigenValueArrayType, 3> EigenValueImageType;
+typedef itk::ModifiedSheetnessImageFilter<EigenValueImageType, ImageType> ModifiedFilterType;
+typedef itk::DualPolarityModifiedSheetnessImageFilter<EigenValueImageType, ImageType> DualModifiedFilterType;
+typedef itk::KrcahSheetnessImageFilter<EigenValueImageType, double, ImageType> KrcahFilterType;
+typedef itk::DualPolarityKrcahSheetnessImageFilter<EigenValueImageType, double, ImageType> DualKrcahFilterType;
+
+// random eigenvalues of both signs, with some zeros
+EigenValueImageType::Pointer createEigenValues() {
+    EigenValueImageType::SizeType size = {{17, 13, 11}};
+    return TestImages::createRandomEigenValues<EigenValueImageType>(size, 5, 50, 7);
+}
+
+void expectEqualImages(const ImageType *expected, const ImageType *actual) {
+    ASSERT_EQ(expected->GetBufferedRegion(), actual->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> at(actual, actual->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++at) {
+        ASSERT_EQ(et.Get(), at.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(DualPolarityModifiedSheetnessImageFilter, MatchesBothPolarities) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+
+    ModifiedFilterType::Pointer bright = ModifiedFilterType::New();
+    bright->SetInput(eigenValues);
+    bright->SetNormalization(0.4);
+    bright->SetNoiseNormalization(20);
+    bright->DetectBrightSheetsOn();
+    bright->Update();
+
+    ModifiedFilterType::Pointer dark = ModifiedFilterType::New();
+    dark->SetInput(eigenValues);
+    dark->SetNormalization(0.4);
+    dark->SetNoiseNormalization(20);
+    dark->DetectDarkSheetsOn();
+    dark->Update();
+
+    DualModifiedFilterType::Pointer dual = DualModifiedFilterType::New();
+    dual->SetInput(eigenValues);
+    dual->SetNormalization(0.4);
+    dual->SetNoiseNormalization(20);
+    dual->DetectDarkSheetsOn(); // sets the functor polarity, output 0 stays the bright sheetness
+    dual->Update();
+
+    expectEqualImages(bright->GetOutput(), dual->GetBrightSheetnessOutput());
+    expectEqualImages(dark->GetOutput(), dual->GetDarkSheetnessOutput());
+}
+
+TEST(DualPolarityModifiedSheetnessImageFilter, KeepsFunctorPolarity) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+
+    ModifiedFilterType::Pointer bright = ModifiedFilterType::New();
+    bright->SetInput(eigenValues);
+    bright->DetectBrightSheetsOn();
+    bright->Update();
+
+    ModifiedFilterType::Pointer dark = ModifiedFilterType::New();
+    dark->SetInput(eigenValues);
+    dark->DetectDarkSheetsOn();
+    dark->Update();
+
+    // a polarity set on the functor itself is neither overwritten nor swaps the outputs
+    DualModifiedFilterType::Pointer dual = DualModifiedFilterType::New();
+    dual->SetInput(eigenValues);
+    dual->GetFunctor().DetectDarkSheetsOn();
+    dual->Update();
+
+    EXPECT_FALSE(dual->GetFunctor().IsDetectBrightSheetsOn());
+    expectEqualImages(bright->GetOutput(), dual->GetBrightSheetnessOutput());
+    expectEqualImages(dark->GetOutput(), dual->GetDarkSheetnessOutput());
+}
+
+TEST(DualPolarityKrcahSheetnessImageFilter, MatchesBothPolarities) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+
+    KrcahFilterType::Pointer krcah = KrcahFilterType::New();
+    krcah->SetInput(eigenValues);
+    krcah->SetConstant(40.0);
+    krcah->Update();
+
+    DualKrcahFilterType::Pointer dual = DualKrcahFilterType::New();
+    dual->SetInput(eigenValues);
+    dual->SetConstant(40.0);
+    dual->Update();
+
+    expectEqualImages(krcah->GetOutput(), dual->GetBrightSheetnessOutput());
+
+    itk::ImageRegionConstIterator<ImageType> bt(dual->GetBrightSheetnessOutput(), dual->GetBrightSheetnessOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> dt(dual->GetDarkSheetnessOutput(), dual->GetDarkSheetnessOutput()->GetBufferedRegion());
+    unsigned int numberOfNonZero = 0;
+    for (; !bt.IsAtEnd(); ++bt, ++dt) {
+        ASSERT_EQ(-bt.Get(), dt.Get()) << "at " << bt.GetIndex();
+        numberOfNonZero += bt.Get() != 0;
+    }
+    EXPECT_GT(numberOfNonZero, 0u);
+}
@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkCommand.h"
+#include "TraceImageFilter.h"
+#include "KrcahHessianSheetnessImageFilter.h"
+#include "TestImages.h"
+
+#include <vector>
+
+typedef itk::SymmetricSecondRankTensor<float, 3> HessianPixelType;
+typedef itk::Image<HessianPixelType, 3> HessianImageType;
+typedef itk::Image<float, 3> ImageType;
+typedef itk::TraceImageFilter<HessianImageType, ImageType> TraceFilterType;
+typedef itk::KrcahHessianSheetnessImageFilter<HessianImageType, ImageType> SheetnessFilterType;
+
+// small Hessians everywhere but in a few slabs, so the work per chunk is uneven with a skip threshold
+HessianImageType::Pointer createHessian() {
+    HessianImageType::SizeType size = {{23, 17, 31}};
+    HessianImageType::Pointer image = TestImages::createRandomHessian<HessianImageType>(size, 7, 1);
+    itk::ImageRegionIterator<HessianImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        const float scale = it.GetIndex()[2] % 8 == 0 ? 100.0f : 0.1f;
+        HessianPixelType hessian = it.Get();
+        for (unsigned int i = 0; i < HessianPixelType::InternalDimension; ++i) {
+            hessian[i] = scale * hessian[i];
+        }
+        it.Set(hessian);
+    }
+    return image;
+}
+
+// records the progress of every ProgressEvent
+class ProgressRecorder : public itk::Command {
+public:
+    typedef ProgressRecorder Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkNewMacro(Self);
+
+    std::vector<float> Progress;
+
+    void Execute(itk::Object *caller, const itk::EventObject &event) ITK_OVERRIDE {
+        Execute(static_cast<const itk::Object *>(caller), event);
+    }
+
+    void Execute(const itk::Object *caller, const itk::EventObject &event) ITK_OVERRIDE {
+        if (itk::ProgressEvent().CheckEvent(&event)) {
+            Progress.push_back(static_cast<const itk::ProcessObject *>(caller)->GetProgress());
+        }
+    }
+};
+
+TEST(DynamicThreadedImageFilter, EveryVoxelIsWrittenOnce) {
+    HessianImageType::Pointer hessian = createHessian();
+
+    const unsigned int chunksPerThread[] = {1, 3, 16, 1000};
+    for (unsigned int c = 0; c < 4; ++c) {
+        TraceFilterType::Pointer filter = TraceFilterType::New();
+        filter->SetInput(hessian);
+        filter->SetNumberOfThreads(4);
+        filter->SetNumberOfChunksPerThread(chunksPerThread[c]);
+        filter->Update();
+        EXPECT_GE(filter->GetNumberOfChunks(), 1u);
+        EXPECT_LE(filter->GetNumberOfChunks(), 4 * chunksPerThread[c]);
+
+        itk::ImageRegionConstIterator<HessianImageType> ht(hessian, hessian->GetBufferedRegion());
+        itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+        for (; !ht.IsAtEnd(); ++ht, ++ot) {
+            const HessianPixelType &h = ht.Get();
+            ASSERT_EQ(h(0, 0) + h(1, 1) + h(2, 2), ot.Get()) << "at " << ht.GetIndex();
+        }
+    }
+}
+
+TEST(DynamicThreadedImageFilter, ChunksAreFinerThanThreads) {
+    TraceFilterType::Pointer filter = TraceFilterType::New();
+    filter->SetInput(createHessian());
+    filter->SetNumberOfThreads(2);
+    filter->Update();
+    EXPECT_GT(filter->GetNumberOfChunks(), 2u);
+}
+
+TEST(DynamicThreadedImageFilter, PerThreadCountsAreSummedOverTheChunks) {
+    HessianImageType::Pointer hessian = createHessian();
+
+    SheetnessFilterType::Pointer reference = SheetnessFilterType::New();
+    reference->SetInput(hessian);
+    reference->SetTraceMean(10.0);
+    reference->SetSkipThreshold(0.1);
+    reference->SetNumberOfThreads(1);
+    reference->SetNumberOfChunksPerThread(1);
+    reference->Update();
+    EXPECT_GT(reference->GetNumberOfSkippedPixels(), 0u);
+
+    SheetnessFilterType::Pointer filter = SheetnessFilterType::New();
+    filter->SetInput(hessian);
+    filter->SetTraceMean(10.0);
+    filter->SetSkipThreshold(0.1);
+    filter->SetNumberOfThreads(3);
+    filter->SetNumberOfChunksPerThread(32);
+    filter->Update();
+    EXPECT_EQ(reference->GetNumberOfSkippedPixels(), filter->GetNumberOfSkippedPixels());
+
+    itk::ImageRegionConstIterator<ImageType> rt(reference->GetOutput(), reference->GetOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !rt.IsAtEnd(); ++rt, ++ot) {
+        ASSERT_EQ(rt.Get(), ot.Get()) << "at " << rt.GetIndex();
+    }
+}
+
+TEST(DynamicThreadedImageFilter, ProgressNeverGoesBack) {
+    SheetnessFilterType::Pointer filter = SheetnessFilterType::New();
+    filter->SetInput(createHessian());
+    filter->SetTraceMean(10.0);
+    filter->SetNumberOfThreads(3);
+    filter->SetNumberOfChunksPerThread(16);
+
+    ProgressRecorder::Pointer recorder = ProgressRecorder::New();
+    filter->AddObserver(itk::ProgressEvent(), recorder);
+    filter->Update();
+
+    ASSERT_FALSE(recorder->Progress.empty());
+    for (size_t i = 1; i < recorder->Progress.size(); ++i) {
+        ASSERT_GE(recorder->Progress[i], recorder->Progress[i - 1]) << "at event " << i;
+    }
+    EXPECT_FLOAT_EQ(1.0f, recorder->Progress.back());
+}
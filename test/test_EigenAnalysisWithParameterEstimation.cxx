@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkSymmetricEigenAnalysisImageFilter.h"
+#include "AutomaticSheetnessParameterEstimationImageFilter.h"
+#include "EigenAnalysisWithParameterEstimationImageFilter.h"
+#include "TestImages.h"
+
+typedef itk::SymmetricSecondRankTensor<double, 3> HessianPixelType;
+typedef itk::Image<HessianPixelType, 3> HessianImageType;
+typedef itk::FixedArray<double, 3> EigenValueArrayType;
+typedef itk::Image<EigenValueArrayType, 3> EigenValueImageType;
+typedef itk::Image<unsigned char, 3> MaskImageType;
+typedef itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType> EigenAnalysisFilterType;
+typedef itk::AutomaticSheetnessParameterEstimationImageFilter<EigenValueImageType, MaskImageType> EstimationFilterType;
+typedef itk::EigenAnalysisWithParameterEstimationImageFilter<HessianImageType, EigenValueImageType, MaskImageType> CombinedFilterType;
+
+HessianImageType::Pointer createHessian() {
+    HessianImageType::SizeType size = {{17, 13, 11}};
+    return TestImages::createRandomHessian<HessianImageType>(size, 23, 300);
+}
+
+MaskImageType::Pointer createMask(const HessianImageType *image) {
+    MaskImageType::Pointer mask = MaskImageType::New();
+    mask->SetRegions(image->GetLargestPossibleRegion());
+    mask->Allocate();
+    itk::ImageRegionIterator<MaskImageType> it(mask, mask->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        it.Set(it.GetIndex()[1] < 6 ? 1 : 0);
+    }
+    return mask;
+}
+
+TEST(EigenAnalysisWithParameterEstimationImageFilter, MatchesSeparateFilters) {
+    HessianImageType::Pointer hessian = createHessian();
+    MaskImageType::Pointer mask = createMask(hessian);
+
+    EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+    eigen->SetDimension(3);
+    eigen->SetInput(hessian);
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigen->GetOutput());
+    estimation->SetLabelInput(mask);
+    estimation->SetLabel(1);
+    estimation->SetScale(0.05);
+    estimation->Update();
+
+    CombinedFilterType::Pointer combined = CombinedFilterType::New();
+    combined->SetDimension(3);
+    combined->SetInput(hessian);
+    combined->SetLabelInput(mask);
+    combined->SetLabel(1);
+    combined->SetScale(0.05);
+    combined->Update();
+
+    EXPECT_DOUBLE_EQ(estimation->GetC(), combined->GetC());
+    EXPECT_EQ(estimation->GetAlpha(), combined->GetAlpha());
+    EXPECT_EQ(estimation->GetBeta(), combined->GetBeta());
+
+    itk::ImageRegionConstIterator<EigenValueImageType> et(eigen->GetOutput(), eigen->GetOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<EigenValueImageType> ct(combined->GetOutput(), combined->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ct) {
+        for (unsigned int i = 0; i < 3; ++i) {
+            ASSERT_EQ(et.Get()[i], ct.Get()[i]) << "at " << et.GetIndex();
+        }
+    }
+}
+
+TEST(EigenAnalysisWithParameterEstimationImageFilter, QuantileMatchesSeparateFilters) {
+    HessianImageType::Pointer hessian = createHessian();
+
+    EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+    eigen->SetDimension(3);
+    eigen->SetInput(hessian);
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigen->GetOutput());
+    estimation->UseQuantileOn();
+    estimation->SetQuantile(0.9);
+    estimation->Update();
+
+    CombinedFilterType::Pointer combined = CombinedFilterType::New();
+    combined->SetDimension(3);
+    combined->SetInput(hessian);
+    combined->UseQuantileOn();
+    combined->SetQuantile(0.9);
+    combined->Update();
+
+    EXPECT_DOUBLE_EQ(estimation->GetC(), combined->GetC());
+}
+
+TEST(EigenAnalysisWithParameterEstimationImageFilter, SampledMatchesSeparateFilters) {
+    HessianImageType::Pointer hessian = createHessian();
+    MaskImageType::Pointer mask = createMask(hessian);
+
+    const EstimationFilterType::SamplingModeType modes[] = {EstimationFilterType::StrideSampling,
+                                                             EstimationFilterType::RandomSampling};
+    const CombinedFilterType::SamplingModeType combinedModes[] = {CombinedFilterType::StrideSampling,
+                                                                  CombinedFilterType::RandomSampling};
+    for (unsigned int i = 0; i < 2; ++i) {
+        EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+        eigen->SetDimension(3);
+        eigen->SetInput(hessian);
+        EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+        estimation->SetInput(eigen->GetOutput());
+        estimation->SetLabelInput(mask);
+        estimation->UseQuantileOn();
+        estimation->SetQuantile(0.9);
+        estimation->SetSamplingMode(modes[i]);
+        estimation->SetNumberOfSamples(300);
+        estimation->SetSeed(3);
+        estimation->Update();
+
+        CombinedFilterType::Pointer combined = CombinedFilterType::New();
+        combined->SetDimension(3);
+        combined->SetInput(hessian);
+        combined->SetLabelInput(mask);
+        combined->UseQuantileOn();
+        combined->SetQuantile(0.9);
+        combined->SetSamplingMode(combinedModes[i]);
+        combined->SetNumberOfSamples(300);
+        combined->SetSeed(3);
+        combined->Update();
+
+        // the same voxels are sampled, the full eigenvalue image is still written
+        EXPECT_LT(combined->GetNumberOfSampledPixels(), 300u) << "mode " << modes[i];
+        EXPECT_EQ(estimation->GetNumberOfSampledPixels(), combined->GetNumberOfSampledPixels()) << "mode " << modes[i];
+        EXPECT_DOUBLE_EQ(estimation->GetC(), combined->GetC()) << "mode " << modes[i];
+        EXPECT_DOUBLE_EQ(estimation->GetCLowerBound(), combined->GetCLowerBound()) << "mode " << modes[i];
+        EXPECT_DOUBLE_EQ(estimation->GetCUpperBound(), combined->GetCUpperBound()) << "mode " << modes[i];
+        EXPECT_EQ(hessian->GetBufferedRegion(), combined->GetOutput()->GetBufferedRegion());
+    }
+}
@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+
+#include "FastExp.h"
+
+#include <cmath>
+#include <limits>
+
+TEST(FastExp, RelativeErrorBound) {
+    double worst = 0;
+    for (double x = -708.0; x <= 709.0; x += 1.0 / 1024 + 1e-7) {
+        const double exact = std::exp(x);
+        worst = std::max(worst, std::fabs(itk::FastExp(x) - exact) / exact);
+    }
+    EXPECT_LT(worst, itk::FastExpMaximumRelativeError);
+}
+
+TEST(FastExp, RelativeErrorBoundSheetnessRange) {
+    // the arguments of the sheetness measures, -(R / alpha)^2, are mostly in [-50, 0]
+    for (double x = -50.0; x <= 0.0; x += 1e-4) {
+        const double exact = std::exp(x);
+        ASSERT_LT(std::fabs(itk::FastExp(x) - exact), itk::FastExpMaximumRelativeError * exact) << "x = " << x;
+    }
+}
+
+TEST(FastExp, ExactPoints) {
+    EXPECT_EQ(1.0, itk::FastExp(0.0));
+    EXPECT_EQ(1.0, itk::FastExp(-0.0));
+    EXPECT_NEAR(std::exp(1.0), itk::FastExp(1.0), itk::FastExpMaximumRelativeError * std::exp(1.0));
+    EXPECT_NEAR(std::exp(-1.0), itk::FastExp(-1.0), itk::FastExpMaximumRelativeError * std::exp(-1.0));
+}
+
+TEST(FastExp, Limits) {
+    EXPECT_EQ(0.0, itk::FastExp(-709.0));
+    EXPECT_EQ(0.0, itk::FastExp(-1e300));
+    EXPECT_EQ(0.0, itk::FastExp(-std::numeric_limits<double>::infinity()));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), itk::FastExp(710.0));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), itk::FastExp(std::numeric_limits<double>::infinity()));
+    EXPECT_TRUE(std::isnan(itk::FastExp(std::numeric_limits<double>::quiet_NaN())));
+}
@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkSymmetricEigenAnalysisImageFilter.h"
+#include "SharedPassHessianRecursiveGaussianImageFilter.h"
+#include "KrcahSheetnessImageFilter.h"
+#include "KrcahHessianSheetnessImageFilter.h"
+#include "TestImages.h"
+
+#include <cmath>
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::SharedPassHessianRecursiveGaussianImageFilter<ImageType> HessianFilterType;
+typedef HessianFilterType::OutputImageType HessianImageType;
+typedef itk::KrcahHessianSheetnessImageFilter<HessianImageType, ImageType> FilterType;
+typedef FilterType::EigenValueArrayType EigenValueArrayType;
+typedef itk::Image<EigenValueArrayType, 3> EigenValueImageType;
+typedef itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType> EigenAnalysisFilterType;
+typedef itk::KrcahSheetnessImageFilter<EigenValueImageType, double, ImageType> SheetnessFilterType;
+
+// a bright plate in a flat background with little noise, most of the Hessians are small
+HessianImageType::Pointer createHessian() {
+    ImageType::SizeType size = {{29, 19, 13}};
+    ImageType::Pointer image = TestImages::createRandomImage<ImageType>(size, 3, 5);
+    itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        it.Set((std::abs(it.GetIndex()[0] - 14) <= 1 ? 1000.0f : 0.0f) + it.Get());
+    }
+
+    HessianFilterType::Pointer hessian = HessianFilterType::New();
+    hessian->SetInput(image);
+    hessian->SetSigma(1.0);
+    hessian->Update();
+    return hessian->GetOutput();
+}
+
+ImageType::Pointer reference(const HessianImageType *hessian, double traceMean) {
+    EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+    eigen->SetDimension(3);
+    eigen->SetInput(hessian);
+
+    SheetnessFilterType::Pointer sheetness = SheetnessFilterType::New();
+    sheetness->SetInput(eigen->GetOutput());
+    sheetness->SetConstant(traceMean);
+    sheetness->Update();
+    return sheetness->GetOutput();
+}
+
+// a mean trace that is not tiny compared to the Hessians of the background
+const double traceMean = 50.0;
+
+TEST(KrcahHessianSheetnessImageFilter, MatchesEigenAnalysisAndSheetnessWithoutSkipping) {
+    HessianImageType::Pointer hessian = createHessian();
+    ImageType::Pointer expected = reference(hessian, traceMean);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(hessian);
+    filter->SetTraceMean(traceMean);
+    filter->Update();
+    EXPECT_EQ(0u, filter->GetNumberOfSkippedPixels());
+    EXPECT_EQ(0.0, filter->GetMaximumSkipError());
+
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(KrcahHessianSheetnessImageFilter, SkippedVoxelsStayWithinTheBound) {
+    HessianImageType::Pointer hessian = createHessian();
+    ImageType::Pointer expected = reference(hessian, traceMean);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(hessian);
+    filter->SetTraceMean(traceMean);
+    filter->SetSkipThreshold(0.05);
+    filter->SetNumberOfThreads(3);
+    filter->Update();
+
+    const double bound = filter->GetMaximumSkipError();
+    EXPECT_NEAR(3 * 0.05 * 0.05 / (0.25 * 0.25), bound, 1e-12);
+    EXPECT_GT(filter->GetNumberOfSkippedPixels(), 0u);
+    EXPECT_EQ(expected->GetBufferedRegion().GetNumberOfPixels(), filter->GetNumberOfPixels());
+
+    double maximumError = 0;
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        maximumError = std::max(maximumError, std::fabs(static_cast<double>(et.Get()) - ot.Get()));
+        // evaluated voxels are unchanged
+        if (ot.Get() != 0) {
+            ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+        }
+    }
+    EXPECT_LE(maximumError, bound);
+    EXPECT_GT(filter->GetSkippedFraction(), 0.0);
+    EXPECT_LT(filter->GetSkippedFraction(), 1.0);
+}
+
+TEST(KrcahHessianSheetnessImageFilter, OccupancyGatesWholeBlocks) {
+    HessianImageType::Pointer hessian = createHessian();
+    ImageType::Pointer expected = reference(hessian, traceMean);
+
+    // blocks of 8^3 voxels, the first column of blocks along x is empty
+    FilterType::OccupancyImageType::Pointer occupancy = FilterType::OccupancyImageType::New();
+    FilterType::OccupancyImageType::SizeType size = {{4, 3, 2}};
+    occupancy->SetRegions(size);
+    occupancy->SetSpacing(8.0);
+    occupancy->SetOrigin(3.5);
+    occupancy->Allocate();
+    itk::ImageRegionIterator<FilterType::OccupancyImageType> bt(occupancy, occupancy->GetBufferedRegion());
+    for (; !bt.IsAtEnd(); ++bt) {
+        bt.Set(bt.GetIndex()[0] > 0);
+    }
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(hessian);
+    filter->SetTraceMean(traceMean);
+    filter->SetOccupancy(occupancy);
+    filter->Update();
+    EXPECT_EQ(8u * 19u * 13u, filter->GetNumberOfGatedPixels());
+    EXPECT_EQ(0u, filter->GetNumberOfSkippedPixels());
+
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        if (et.GetIndex()[0] < 8) {
+            ASSERT_EQ(0.0f, ot.Get()) << "at " << et.GetIndex();
+        } else {
+            ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+        }
+    }
+}
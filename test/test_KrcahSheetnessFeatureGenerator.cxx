@@ -0,0 +1,356 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "KrcahSheetnessFeatureGenerator.h"
+#include "FastExp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+typedef itk::Image<short, 3> InputImageType;
+typedef itk::Image<float, 3> OutputImageType;
+typedef itk::KrcahSheetnessFeatureGenerator<InputImageType, OutputImageType> GeneratorType;
+typedef GeneratorType::ScaleIndexImageType ScaleIndexImageType;
+
+// a thin and a thick bright plate in noise, so the winning scale varies over the image
+InputImageType::Pointer createImage() {
+    InputImageType::Pointer image = InputImageType::New();
+    InputImageType::SizeType size = {{41, 23, 17}};
+    image->SetRegions(size);
+    image->Allocate();
+
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<short> noise(-40, 40);
+    itk::ImageRegionIterator<InputImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        const InputImageType::IndexType idx = it.GetIndex();
+        const bool plate = idx[0] == 10 || std::abs(idx[0] - 28) <= 3;
+        it.Set((plate ? 1200 : 0) + noise(generator));
+    }
+    return image;
+}
+
+OutputImageType::Pointer generateSheetness(const InputImageType *image, const GeneratorType::SheetnessScalesType &scales) {
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->Update();
+    return generator->GetOutput();
+}
+
+TEST(KrcahSheetnessFeatureGenerator, ScaleIndexOutputIsArgmaxOverTheScales) {
+    InputImageType::Pointer image = createImage();
+
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    scales.push_back(2.0);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetGenerateScaleIndexOutput(true);
+    generator->Update();
+    ASSERT_TRUE(generator->GetScaleIndexOutput() != ITK_NULLPTR);
+
+    // every scale on its own
+    std::vector<OutputImageType::Pointer> perScale;
+    for (size_t k = 0; k < scales.size(); ++k) {
+        perScale.push_back(generateSheetness(image, GeneratorType::SheetnessScalesType(1, scales[k])));
+    }
+
+    std::vector<unsigned int> histogram(scales.size(), 0);
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ScaleIndexImageType> st(generator->GetScaleIndexOutput(),
+                                                          generator->GetScaleIndexOutput()->GetBufferedRegion());
+    for (; !ot.IsAtEnd(); ++ot, ++st) {
+        const OutputImageType::IndexType index = ot.GetIndex();
+        size_t first = 0;
+        for (size_t k = 1; k < scales.size(); ++k) {
+            if (std::fabs(perScale[k]->GetPixel(index)) > std::fabs(perScale[first]->GetPixel(index))) {
+                first = k;
+            }
+        }
+        ASSERT_EQ(first, st.Get()) << "at " << index;
+        ASSERT_EQ(perScale[first]->GetPixel(index), ot.Get()) << "at " << index;
+        ++histogram[st.Get()];
+    }
+
+    // the thin and the thick plate respond at different scales
+    EXPECT_GT(histogram.front() + histogram[1], 0u);
+    EXPECT_GT(histogram.back(), 0u);
+}
+
+TEST(KrcahSheetnessFeatureGenerator, ScaleIndexOutputDoesNotChangeTheSheetness) {
+    InputImageType::Pointer image = createImage();
+
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    EXPECT_TRUE(generator->GetScaleIndexOutput() == ITK_NULLPTR);
+    generator->SetGenerateScaleIndexOutput(true);
+    generator->Update();
+
+    itk::ImageRegionConstIterator<OutputImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(KrcahSheetnessFeatureGenerator, ScaleSpaceDetectsThePlates) {
+    InputImageType::Pointer image = createImage();
+
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    scales.push_back(2.0);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetUseScaleSpace(true);
+    generator->Update();
+
+    // the thin plate is a bright sheet with a positive sheetness, much larger than anything in the background
+    double plate = 0;
+    double background = 0;
+    unsigned int platePixels = 0;
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !ot.IsAtEnd(); ++ot) {
+        const OutputImageType::IndexType index = ot.GetIndex();
+        if (index[0] == 10) {
+            plate += ot.Get();
+            ++platePixels;
+        } else if (std::abs(index[0] - 10) > 3 && std::abs(index[0] - 28) > 6) {
+            background += std::fabs(ot.Get());
+        }
+    }
+    plate /= platePixels;
+    background /= generator->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+    EXPECT_GT(plate, 0);
+    EXPECT_GT(plate, 5 * background);
+}
+
+TEST(KrcahSheetnessFeatureGenerator, ScaleSpaceNeedsAscendingScales) {
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(1.0);
+    scales.push_back(0.75);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(createImage());
+    generator->SetSheetnessScales(scales);
+    generator->SetUseScaleSpace(true);
+    EXPECT_THROW(generator->Update(), itk::ExceptionObject);
+}
+
+// the mean sheetness on the thin plate and the mean absolute sheetness away from both plates
+void plateAndBackground(const OutputImageType *sheetness, double &plate, double &background) {
+    plate = 0;
+    background = 0;
+    unsigned int platePixels = 0;
+    unsigned int backgroundPixels = 0;
+    itk::ImageRegionConstIterator<OutputImageType> ot(sheetness, sheetness->GetBufferedRegion());
+    for (; !ot.IsAtEnd(); ++ot) {
+        const OutputImageType::IndexType index = ot.GetIndex();
+        if (index[0] == 10) {
+            plate += ot.Get();
+            ++platePixels;
+        } else if (std::abs(index[0] - 10) > 6 && std::abs(index[0] - 28) > 9) {
+            background += std::fabs(ot.Get());
+            ++backgroundPixels;
+        }
+    }
+    plate /= platePixels;
+    background /= backgroundPixels;
+}
+
+TEST(KrcahSheetnessFeatureGenerator, ScaleSpaceAgreesWithTheRecursiveHessian) {
+    InputImageType::Pointer image = createImage();
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    scales.push_back(2.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetUseScaleSpace(true);
+    generator->Update();
+
+    // the central differences change the magnitude of the response, not where it is
+    double plate, background, expectedPlate, expectedBackground;
+    plateAndBackground(generator->GetOutput(), plate, background);
+    plateAndBackground(expected, expectedPlate, expectedBackground);
+    EXPECT_NEAR(expectedPlate, plate, 0.2 * expectedPlate);
+    EXPECT_LT(background, 0.2 * plate);
+
+    double sum = 0, expectedSum = 0, squares = 0, expectedSquares = 0, products = 0;
+    itk::ImageRegionConstIterator<OutputImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        sum += ot.Get();
+        expectedSum += et.Get();
+        squares += ot.Get() * ot.Get();
+        expectedSquares += et.Get() * et.Get();
+        products += ot.Get() * et.Get();
+    }
+    const double n = expected->GetBufferedRegion().GetNumberOfPixels();
+    const double covariance = products / n - sum / n * expectedSum / n;
+    const double correlation = covariance / std::sqrt((squares / n - sum / n * sum / n) *
+                                                      (expectedSquares / n - expectedSum / n * expectedSum / n));
+    EXPECT_GT(correlation, 0.8);
+}
+
+TEST(KrcahSheetnessFeatureGenerator, PyramidKeepsTheInputGrid) {
+    InputImageType::Pointer image = createImage();
+    GeneratorType::SheetnessScalesType scales(1, 2.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetPyramidThreshold(2);
+    generator->Update();
+    OutputImageType *sheetness = generator->GetOutput();
+    EXPECT_EQ(image->GetLargestPossibleRegion(), sheetness->GetBufferedRegion());
+
+    // The response of the plate at the scale survives the coarse grid. At sigma = 2 on a grid shrunk by 2 the
+    // central differences see sigma = 1 voxel and underestimate the second derivative by about 21%, the sheetness
+    // saturates at the plate and changes by less.
+    double plate, background, expectedPlate, expectedBackground;
+    plateAndBackground(sheetness, plate, background);
+    plateAndBackground(expected, expectedPlate, expectedBackground);
+    EXPECT_GT(expectedPlate, 0);
+    EXPECT_NEAR(expectedPlate, plate, 0.25 * expectedPlate);
+    // the background is close to 0, compare it on the scale of the plate
+    EXPECT_NEAR(expectedBackground, background, 0.05 * expectedPlate);
+    EXPECT_GT(plate, 5 * background);
+}
+
+TEST(KrcahSheetnessFeatureGenerator, PyramidShrinkFactorIsAPowerOfTwo) {
+    GeneratorType::Pointer generator = GeneratorType::New();
+    EXPECT_THROW(generator->SetPyramidMaximumShrinkFactor(0), itk::ExceptionObject);
+    EXPECT_THROW(generator->SetPyramidMaximumShrinkFactor(3), itk::ExceptionObject);
+    EXPECT_THROW(generator->SetPyramidMaximumShrinkFactor(6), itk::ExceptionObject);
+    EXPECT_NO_THROW(generator->SetPyramidMaximumShrinkFactor(1));
+    EXPECT_NO_THROW(generator->SetPyramidMaximumShrinkFactor(2));
+    EXPECT_NO_THROW(generator->SetPyramidMaximumShrinkFactor(8));
+}
+
+TEST(KrcahSheetnessFeatureGenerator, PyramidBelowTheThresholdIsUnchanged) {
+    InputImageType::Pointer image = createImage();
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetPyramidThreshold(2);
+    generator->Update();
+
+    itk::ImageRegionConstIterator<OutputImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(KrcahSheetnessFeatureGenerator, LowContrastSkipReport) {
+    InputImageType::Pointer image = createImage();
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetLowContrastSkipThreshold(0.01);
+    generator->Update();
+
+    const double bound = generator->GetLowContrastMaximumError();
+    EXPECT_GE(generator->GetLowContrastSkippedFraction(), 0.0);
+    EXPECT_LT(generator->GetLowContrastSkippedFraction(), 1.0);
+    EXPECT_LE(bound, 2 * 3 * 0.01 * 0.01 / (0.25 * 0.25));
+
+    // the bound covers the reduction over the scales
+    itk::ImageRegionConstIterator<OutputImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_LE(std::fabs(static_cast<double>(et.Get()) - ot.Get()), bound + 1e-7) << "at " << et.GetIndex();
+    }
+}
+
+TEST(KrcahSheetnessFeatureGenerator, IntensityGateSkipsBlocksFarFromDenseVoxels) {
+    // the thin plate only, with air on both sides
+    InputImageType::Pointer image = InputImageType::New();
+    InputImageType::SizeType size = {{64, 16, 16}};
+    image->SetRegions(size);
+    image->Allocate();
+    itk::ImageRegionIterator<InputImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        it.Set(it.GetIndex()[0] == 4 ? 1200 : -1000);
+    }
+
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetUseIntensityGate(true);
+    generator->Update();
+    EXPECT_GT(generator->GetIntensityGatedFraction(), 0.0);
+    EXPECT_LT(generator->GetIntensityGatedFraction(), 1.0);
+
+    // the plate and its surroundings are unchanged, the air far away is 0
+    itk::ImageRegionConstIterator<OutputImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        if (et.GetIndex()[0] < 16) {
+            ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+        } else if (et.GetIndex()[0] >= 32) {
+            ASSERT_EQ(0.0f, ot.Get()) << "at " << et.GetIndex();
+        }
+    }
+    EXPECT_GT(generator->GetOutput()->GetPixel({{4, 8, 8}}), 0.0f);
+}
+
+TEST(KrcahSheetnessFeatureGenerator, FastExpStaysWithinItsErrorBound) {
+    InputImageType::Pointer image = createImage();
+    GeneratorType::SheetnessScalesType scales;
+    scales.push_back(0.75);
+    scales.push_back(1.0);
+    scales.push_back(2.0);
+    OutputImageType::Pointer expected = generateSheetness(image, scales);
+
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetInput(image);
+    generator->SetSheetnessScales(scales);
+    generator->SetUseFastExp(true);
+    generator->Update();
+
+    // the sheetness is a product of three factors in [0, 1], each within FastExpMaximumRelativeError of its value
+    double maximumError = 0;
+    itk::ImageRegionConstIterator<OutputImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> ot(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        maximumError = std::max(maximumError, std::fabs(static_cast<double>(et.Get()) - ot.Get()));
+    }
+    EXPECT_LE(maximumError, 4 * itk::FastExpMaximumRelativeError);
+}
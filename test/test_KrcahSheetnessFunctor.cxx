@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+
+#include "itkFixedArray.h"
+#include "KrcahSheetnessFunctor.h"
+
+#include <random>
+#include <vector>
+
+typedef itk::FixedArray<double, 3> EigenValueArrayType;
+typedef itk::Functor::KrcahSheetness<EigenValueArrayType, double, double> FunctorType;
+
+// eigenvalues with both signs, exact ties and zeros so every branch of the scalar path is taken
+std::vector<EigenValueArrayType> createEigenValues(size_t n) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> value(-100, 100);
+    std::uniform_int_distribution<int> kind(0, 9);
+
+    std::vector<EigenValueArrayType> eigenValues(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            switch (kind(generator)) {
+                case 0:
+                    eigenValues[i][j] = 0;
+                    break;
+                case 1:
+                    eigenValues[i][j] = 1e-20;
+                    break;
+                case 2:
+                    eigenValues[i][j] = j > 0 ? -eigenValues[i][j - 1] : 1;
+                    break;
+                default:
+                    eigenValues[i][j] = value(generator);
+                    break;
+            }
+        }
+    }
+    return eigenValues;
+}
+
+void expectBatchEqualsScalar(size_t n, std::ptrdiff_t traceStride, bool useFastExp = false) {
+    std::vector<EigenValueArrayType> eigenValues = createEigenValues(n);
+    std::vector<double> trace(n);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> value(1, 300);
+    for (size_t i = 0; i < n; ++i) {
+        trace[i] = value(generator);
+    }
+
+    FunctorType functor;
+    functor.SetAlpha(0.4);
+    functor.SetBeta(0.6);
+    functor.SetGamma(0.3);
+    functor.SetUseFastExp(useFastExp);
+
+    std::vector<double> batch(n);
+    functor.Evaluate(eigenValues.data(), trace.data(), traceStride, batch.data(), n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const double scalar = functor(eigenValues[i], trace[i * traceStride]);
+        // bitwise equal, the batch path does the same operations in the same order
+        EXPECT_EQ(scalar, batch[i]) << "voxel " << i << " (" << eigenValues[i][0] << ", " << eigenValues[i][1]
+                                    << ", " << eigenValues[i][2] << ")";
+    }
+}
+
+TEST(KrcahSheetnessFunctor, BatchEqualsScalarWithTraceImage) {
+    expectBatchEqualsScalar(1000, 1);
+}
+
+TEST(KrcahSheetnessFunctor, BatchEqualsScalarWithConstantTrace) {
+    expectBatchEqualsScalar(1000, 0);
+}
+
+TEST(KrcahSheetnessFunctor, BatchShorterThanBlock) {
+    expectBatchEqualsScalar(FunctorType::BatchSize - 1, 1);
+    expectBatchEqualsScalar(1, 0);
+}
+
+TEST(KrcahSheetnessFunctor, BatchEqualsScalarWithFastExp) {
+    expectBatchEqualsScalar(1000, 1, true);
+    expectBatchEqualsScalar(1000, 0, true);
+}
+
+TEST(KrcahSheetnessFunctor, FastExpError) {
+    const size_t n = 10000;
+    std::vector<EigenValueArrayType> eigenValues = createEigenValues(n);
+
+    FunctorType exact;
+    FunctorType fast;
+    fast.SetUseFastExp(true);
+    for (size_t i = 0; i < n; ++i) {
+        // three factors with a relative error below FastExpMaximumRelativeError each, |sheetness| <= 1
+        ASSERT_NEAR(exact(eigenValues[i], 150.0), fast(eigenValues[i], 150.0), 4 * itk::FastExpMaximumRelativeError);
+    }
+}
+
+TEST(KrcahSheetnessFunctor, BatchOfZeros) {
+    std::vector<EigenValueArrayType> eigenValues(3 * FunctorType::BatchSize + 5);
+    for (size_t i = 0; i < eigenValues.size(); ++i) {
+        eigenValues[i].Fill(0);
+    }
+    const double trace = 0;
+    std::vector<double> batch(eigenValues.size(), 1);
+
+    FunctorType functor;
+    functor.Evaluate(eigenValues.data(), &trace, 0, batch.data(), eigenValues.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(0.0, batch[i]);
+    }
+}
+
+TEST(KrcahSheetnessFunctor, EmptyBatch) {
+    FunctorType functor;
+    const double trace = 1;
+    functor.Evaluate(ITK_NULLPTR, &trace, 0, ITK_NULLPTR, 0);
+}
+
+typedef itk::FixedArray<double, 2> EigenValueArray2DType;
+typedef itk::Functor::KrcahSheetness<EigenValueArray2DType, double, double> Functor2DType;
+
+TEST(KrcahSheetnessFunctor, Batch2DEqualsScalar) {
+    const size_t n = 1000;
+    std::vector<EigenValueArrayType> eigenValues3D = createEigenValues(n);
+    std::vector<EigenValueArray2DType> eigenValues(n);
+    for (size_t i = 0; i < n; ++i) {
+        eigenValues[i][0] = eigenValues3D[i][0];
+        eigenValues[i][1] = eigenValues3D[i][1];
+    }
+
+    Functor2DType functor;
+    functor.SetAlpha(0.4);
+    functor.SetGamma(0.3);
+
+    std::vector<double> batch(n);
+    const double trace = 150;
+    functor.Evaluate(eigenValues.data(), &trace, 0, batch.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(functor(eigenValues[i], trace), batch[i]) << "voxel " << i << " (" << eigenValues[i][0] << ", "
+                                                            << eigenValues[i][1] << ")";
+    }
+}
+
+TEST(KrcahSheetnessFunctor, Sheetness2DDetectsLines) {
+    Functor2DType functor;
+    EigenValueArray2DType brightLine, darkLine, blob;
+    brightLine[0] = -0.5;
+    brightLine[1] = -100;
+    darkLine[0] = 100;
+    darkLine[1] = 0.5;
+    blob.Fill(-100);
+
+    EXPECT_GT(functor(brightLine, 50), 0.99);
+    EXPECT_LT(functor(darkLine, 50), -0.99);
+    EXPECT_LT(functor(blob, 50), 0.05);
+
+    // there is no tube term in 2D
+    Functor2DType otherBeta;
+    otherBeta.SetBeta(0.01);
+    EXPECT_EQ(functor(brightLine, 50), otherBeta(brightLine, 50));
+    EXPECT_EQ(functor(blob, 50), otherBeta(blob, 50));
+}
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "KrcahSheetnessFeatureGenerator.h"
+#include "KrcahSheetnessParameterSweep.h"
+
+#include <cmath>
+#include <random>
+
+typedef itk::Image<short, 3> InputImageType;
+typedef itk::Image<float, 3> OutputImageType;
+typedef itk::KrcahSheetnessFeatureGenerator<InputImageType, OutputImageType> GeneratorType;
+typedef itk::KrcahSheetnessParameterSweep<InputImageType> SweepType;
+
+// a bright plate in noise
+InputImageType::Pointer createImage() {
+    InputImageType::Pointer image = InputImageType::New();
+    InputImageType::SizeType size = {{31, 23, 17}};
+    image->SetRegions(size);
+    image->Allocate();
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<short> noise(-40, 40);
+    itk::ImageRegionIterator<InputImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        const InputImageType::IndexType idx = it.GetIndex();
+        it.Set((std::abs(idx[0] - 15) <= 1 ? 1200 : 0) + noise(generator));
+    }
+    return image;
+}
+
+SweepType::LabelImageType::Pointer createLabel(const InputImageType *image) {
+    SweepType::LabelImageType::Pointer label = SweepType::LabelImageType::New();
+    label->SetRegions(image->GetLargestPossibleRegion());
+    label->Allocate();
+    itk::ImageRegionIterator<SweepType::LabelImageType> it(label, label->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        it.Set(std::abs(it.GetIndex()[0] - 15) <= 1 ? 1 : 0);
+    }
+    return label;
+}
+
+TEST(KrcahSheetnessParameterSweep, MatchesGenerator) {
+    InputImageType::Pointer image = createImage();
+
+    std::vector<double> alphas;
+    alphas.push_back(0.5);
+    alphas.push_back(0.8);
+    std::vector<double> betas(1, 0.5);
+    std::vector<double> gammas;
+    gammas.push_back(0.25);
+    gammas.push_back(0.5);
+
+    SweepType::Pointer sweep = SweepType::New();
+    sweep->SetInput(image);
+    sweep->SetParameterGrid(alphas, betas, gammas);
+    sweep->GenerateImageOn();
+    sweep->Compute();
+    ASSERT_EQ(4u, sweep->GetNumberOfParameters());
+
+    const SweepType::SweepImageType *sweepImage = sweep->GetImage();
+    ASSERT_TRUE(sweepImage != ITK_NULLPTR);
+    ASSERT_EQ(4u, sweepImage->GetLargestPossibleRegion().GetSize(3));
+
+    for (size_t c = 0; c < sweep->GetNumberOfParameters(); ++c) {
+        const SweepType::ParametersType &parameters = sweep->GetParameters(c);
+        EXPECT_EQ(alphas[c / 2], parameters.Alpha);
+        EXPECT_EQ(gammas[c % 2], parameters.Gamma);
+
+        GeneratorType::Pointer generator = GeneratorType::New();
+        generator->SetInput(image);
+        generator->SetAlpha(parameters.Alpha);
+        generator->SetBeta(parameters.Beta);
+        generator->SetGamma(parameters.Gamma);
+        generator->Update();
+
+        double sum = 0;
+        double minimum = 1e300;
+        double maximum = -1e300;
+        itk::ImageRegionConstIterator<OutputImageType> it(generator->GetOutput(), generator->GetOutput()->GetBufferedRegion());
+        for (; !it.IsAtEnd(); ++it) {
+            SweepType::SweepImageType::IndexType index;
+            for (unsigned int d = 0; d < 3; ++d) {
+                index[d] = it.GetIndex()[d];
+            }
+            index[3] = c;
+            ASSERT_EQ(it.Get(), sweepImage->GetPixel(index)) << "combination " << c << " at " << it.GetIndex();
+            sum += it.Get();
+            minimum = std::min<double>(minimum, it.Get());
+            maximum = std::max<double>(maximum, it.Get());
+        }
+
+        const SweepType::StatisticsType &statistics = sweep->GetStatistics(c);
+        EXPECT_EQ(minimum, statistics.Minimum);
+        EXPECT_EQ(maximum, statistics.Maximum);
+        EXPECT_NEAR(sum / generator->GetOutput()->GetBufferedRegion().GetNumberOfPixels(), statistics.Mean, 1e-9);
+    }
+}
+
+TEST(KrcahSheetnessParameterSweep, LabelStatistics) {
+    InputImageType::Pointer image = createImage();
+
+    SweepType::Pointer sweep = SweepType::New();
+    sweep->SetInput(image);
+    sweep->SetLabelImage(createLabel(image));
+    sweep->AddParameters(0.5, 0.5, 0.25);
+    sweep->SetNumberOfThreads(3);
+    sweep->Compute();
+
+    // the plate is a bright sheet, the background mostly noise
+    const SweepType::StatisticsType &statistics = sweep->GetStatistics(0);
+    EXPECT_GT(statistics.LabelMean, 0);
+    EXPECT_GT(std::fabs(statistics.LabelMean), 5 * std::fabs(statistics.BackgroundMean));
+    EXPECT_TRUE(sweep->GetImage() == ITK_NULLPTR);
+}
+
+TEST(KrcahSheetnessParameterSweep, NoParametersThrows) {
+    SweepType::Pointer sweep = SweepType::New();
+    sweep->SetInput(createImage());
+    EXPECT_THROW(sweep->Compute(), itk::ExceptionObject);
+}
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkHessianRecursiveGaussianImageFilter.h"
+#include "itkStatisticsImageFilter.h"
+#include "TraceImageFilter.h"
+#include "MeanTraceBoundaryFluxCalculator.h"
+
+#include <cmath>
+#include <random>
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::HessianRecursiveGaussianImageFilter<ImageType> HessianFilterType;
+typedef itk::TraceImageFilter<HessianFilterType::OutputImageType, ImageType> TraceFilterType;
+typedef itk::StatisticsImageFilter<ImageType> StatisticsFilterType;
+typedef itk::MeanTraceBoundaryFluxCalculator<ImageType> CalculatorType;
+
+// random image with bright structures touching the boundary, anisotropic spacing and a non-cubic size
+ImageType::Pointer createImage(const ImageType::SizeType &size) {
+    ImageType::Pointer image = ImageType::New();
+    ImageType::RegionType region(size);
+    image->SetRegions(region);
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.7;
+    spacing[1] = 1.0;
+    spacing[2] = 1.3;
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> noise(-100, 100);
+    itk::ImageRegionIterator<ImageType> it(image, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
+        const ImageType::IndexType idx = it.GetIndex();
+        const float sheet = std::fabs(idx[0] - 3.0f) < 1.5f ? 1500.0f : 0.0f;
+        it.Set(sheet + 5.0f * idx[1] * idx[1] - 20.0f * idx[2] + noise(generator));
+    }
+    return image;
+}
+
+void compareWithTraceStatistics(const ImageType::SizeType &size, double sigma) {
+    ImageType::Pointer image = createImage(size);
+
+    // the full pipeline of the Krcah generator
+    HessianFilterType::Pointer hessian = HessianFilterType::New();
+    hessian->SetInput(image);
+    hessian->SetSigma(sigma);
+    TraceFilterType::Pointer trace = TraceFilterType::New();
+    trace->SetInput(hessian->GetOutput());
+    StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+    statistics->SetInput(trace->GetOutput());
+    statistics->Update();
+
+    // the trace image is float, compare relative to its magnitude
+    double meanAbsoluteTrace = 0;
+    itk::ImageRegionConstIterator<ImageType> it(trace->GetOutput(), trace->GetOutput()->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        meanAbsoluteTrace += std::fabs(it.Get());
+    }
+    meanAbsoluteTrace /= trace->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+    ASSERT_GT(meanAbsoluteTrace, 0);
+
+    CalculatorType::Pointer calculator = CalculatorType::New();
+    calculator->SetImage(image);
+    calculator->SetSigma(sigma);
+    calculator->Compute();
+
+    EXPECT_NEAR(statistics->GetMean(), calculator->GetMean(), 1e-4 * meanAbsoluteTrace);
+}
+
+TEST(MeanTraceBoundaryFluxCalculator, MatchesTraceStatisticsSigma075) {
+    ImageType::SizeType size = {{41, 37, 29}};
+    compareWithTraceStatistics(size, 0.75);
+}
+
+TEST(MeanTraceBoundaryFluxCalculator, MatchesTraceStatisticsSigma1) {
+    ImageType::SizeType size = {{41, 37, 29}};
+    compareWithTraceStatistics(size, 1.0);
+}
+
+TEST(MeanTraceBoundaryFluxCalculator, MatchesTraceStatisticsSigma25) {
+    ImageType::SizeType size = {{41, 37, 29}};
+    compareWithTraceStatistics(size, 2.5);
+}
+
+TEST(MeanTraceBoundaryFluxCalculator, MatchesTraceStatisticsSmallImage) {
+    // the slabs of both faces overlap, every voxel is visited
+    ImageType::SizeType size = {{6, 9, 5}};
+    compareWithTraceStatistics(size, 2.0);
+}
+
+TEST(MeanTraceBoundaryFluxCalculator, VisitsOnlyBoundarySlabs) {
+    ImageType::SizeType size = {{96, 96, 96}};
+    ImageType::Pointer image = createImage(size);
+
+    CalculatorType::Pointer calculator = CalculatorType::New();
+    calculator->SetImage(image);
+    calculator->SetSigma(1.0);
+    calculator->Compute();
+
+    const itk::SizeValueType numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+    EXPECT_GT(calculator->GetNumberOfVisitedPixels(), 0u);
+    EXPECT_LT(calculator->GetNumberOfVisitedPixels(), numberOfPixels / 2);
+}
@@ -202,4 +202,27 @@ namespace {
       this->mEigenValueArray[2] = -3;
       EXPECT_DOUBLE_EQ(this->mModifiedSheetness(this->mEigenValueArray), (TypeParam)0.621922134474);
     }
+
+    TYPED_TEST(ModifiedSheetnessFunctorTest, FastExp) {
+      typename TestFixture::FunctorType fast;
+      fast.SetUseFastExp(true);
+      EXPECT_TRUE(fast.GetUseFastExp());
+
+      this->mEigenValueArray[0] = 1;
+      this->mEigenValueArray[1] = 2;
+      this->mEigenValueArray[2] = 3;
+      EXPECT_NEAR(this->mModifiedSheetness(this->mEigenValueArray), fast(this->mEigenValueArray),
+                  4 * itk::FastExpMaximumRelativeError);
+
+      this->mEigenValueArray[0] = 1;
+      this->mEigenValueArray[1] = 2;
+      this->mEigenValueArray[2] = -3;
+      EXPECT_NEAR(this->mModifiedSheetness(this->mEigenValueArray), fast(this->mEigenValueArray),
+                  4 * itk::FastExpMaximumRelativeError);
+
+      this->mEigenValueArray[0] = 0;
+      this->mEigenValueArray[1] = 0;
+      this->mEigenValueArray[2] = 0;
+      EXPECT_DOUBLE_EQ(fast(this->mEigenValueArray), 0);
+    }
 }
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "ModifiedSheetnessImageFilter.h"
+#include "KrcahSheetnessImageFilter.h"
+#include "DescoteauxSheetnessFunctor.h"
+#include "MultiMeasureSheetnessImageFilter.h"
+#include "TestImages.h"
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::FixedArray<double, 3> EigenValueArrayType;
+typedef itk::Image<EigenValueArrayType, 3> EigenValueImageType;
+typedef itk::ModifiedSheetnessImageFilter<EigenValueImageType, ImageType> ModifiedFilterType;
+typedef itk::KrcahSheetnessImageFilter<EigenValueImageType, double, ImageType> KrcahFilterType;
+typedef itk::Functor::DescoteauxSheetness<EigenValueArrayType, float> DescoteauxFunctorType;
+typedef itk::MultiMeasureSheetnessImageFilter<EigenValueImageType, ImageType> MultiMeasureFilterType;
+
+// random eigenvalues of both signs, with some zeros
+EigenValueImageType::Pointer createEigenValues() {
+    EigenValueImageType::SizeType size = {{19, 13, 11}};
+    return TestImages::createRandomEigenValues<EigenValueImageType>(size, 3, 50, 11);
+}
+
+void expectEqualImages(const ImageType *expected, const ImageType *actual) {
+    ASSERT_EQ(expected->GetBufferedRegion(), actual->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> at(actual, actual->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++at) {
+        ASSERT_EQ(et.Get(), at.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(MultiMeasureSheetnessImageFilter, MatchesSeparateFilters) {
+    EigenValueImageType::Pointer eigenValues = createEigenValues();
+
+    ModifiedFilterType::Pointer modified = ModifiedFilterType::New();
+    modified->SetInput(eigenValues);
+    modified->SetNormalization(0.4);
+    modified->SetNoiseNormalization(20);
+    modified->Update();
+
+    KrcahFilterType::Pointer krcah = KrcahFilterType::New();
+    krcah->SetInput(eigenValues);
+    krcah->SetConstant(40.0);
+    krcah->SetAlpha(0.6);
+    krcah->Update();
+
+    DescoteauxFunctorType descoteaux;
+    descoteaux.SetC(30);
+
+    MultiMeasureFilterType::Pointer multiMeasure = MultiMeasureFilterType::New();
+    multiMeasure->SetInput(eigenValues);
+    const unsigned int modifiedIndex = multiMeasure->AddMeasure(modified->GetFunctor());
+    const unsigned int krcahIndex = multiMeasure->AddMeasure(krcah->GetFunctor(), 40.0);
+    const unsigned int descoteauxIndex = multiMeasure->AddMeasure(descoteaux);
+    EXPECT_EQ(0u, modifiedIndex);
+    EXPECT_EQ(1u, krcahIndex);
+    EXPECT_EQ(2u, descoteauxIndex);
+    EXPECT_EQ(3u, multiMeasure->GetNumberOfMeasures());
+    multiMeasure->Update();
+
+    expectEqualImages(modified->GetOutput(), multiMeasure->GetOutput(modifiedIndex));
+    expectEqualImages(krcah->GetOutput(), multiMeasure->GetOutput(krcahIndex));
+
+    const ImageType *output = multiMeasure->GetOutput(descoteauxIndex);
+    itk::ImageRegionConstIterator<EigenValueImageType> et(eigenValues, eigenValues->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(output, output->GetBufferedRegion());
+    unsigned int numberOfNonZero = 0;
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_EQ(descoteaux(et.Get()), ot.Get()) << "at " << et.GetIndex();
+        numberOfNonZero += ot.Get() != 0;
+    }
+    EXPECT_GT(numberOfNonZero, 0u);
+}
+
+TEST(MultiMeasureSheetnessImageFilter, NoMeasureThrows) {
+    MultiMeasureFilterType::Pointer multiMeasure = MultiMeasureFilterType::New();
+    multiMeasure->SetInput(createEigenValues());
+    EXPECT_THROW(multiMeasure->Update(), itk::ExceptionObject);
+}
+
+TEST(DescoteauxSheetnessFunctor, Polarity) {
+    DescoteauxFunctorType descoteaux;
+    EigenValueArrayType eigenValues;
+    eigenValues[0] = 0.1;
+    eigenValues[1] = 0.2;
+    eigenValues[2] = -3;
+    EXPECT_GT(descoteaux(eigenValues), 0);
+
+    descoteaux.SetDetectBrightSheets(false);
+    EXPECT_EQ(0, descoteaux(eigenValues));
+
+    eigenValues[2] = 3;
+    EXPECT_GT(descoteaux(eigenValues), 0);
+
+    eigenValues.Fill(0);
+    EXPECT_EQ(0, descoteaux(eigenValues));
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "MaximumAbsoluteValueImageFilter.h"
+#include "NaryMaximumAbsoluteValueImageFilter.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::MaximumAbsoluteValueImageFilter<ImageType, ImageType, ImageType> BinaryFilterType;
+typedef itk::NaryMaximumAbsoluteValueImageFilter<ImageType> FilterType;
+typedef FilterType::IndexImageType IndexImageType;
+
+// values from a few levels only, so ties between the inputs occur
+ImageType::Pointer createImage(unsigned int seed) {
+    ImageType::Pointer image = ImageType::New();
+    ImageType::SizeType size = {{19, 13, 7}};
+    image->SetRegions(size);
+    image->Allocate();
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> value(-4, 4);
+    itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        it.Set(0.5f * value(generator));
+    }
+    return image;
+}
+
+std::vector<ImageType::Pointer> createImages(unsigned int n) {
+    std::vector<ImageType::Pointer> images;
+    for (unsigned int k = 0; k < n; ++k) {
+        images.push_back(createImage(k + 1));
+    }
+    return images;
+}
+
+// chain of binary filters, the previous way of combining the scales
+ImageType::Pointer reference(const std::vector<ImageType::Pointer> &images) {
+    ImageType::Pointer result = images[0];
+    for (size_t k = 1; k < images.size(); ++k) {
+        BinaryFilterType::Pointer filter = BinaryFilterType::New();
+        filter->SetInput1(result);
+        filter->SetInput2(images[k]);
+        filter->Update();
+        result = filter->GetOutput();
+    }
+    return result;
+}
+
+TEST(NaryMaximumAbsoluteValueImageFilter, MatchesBinaryChain) {
+    std::vector<ImageType::Pointer> images = createImages(4);
+    ImageType::Pointer expected = reference(images);
+
+    FilterType::Pointer filter = FilterType::New();
+    for (size_t k = 0; k < images.size(); ++k) {
+        filter->PushBackInput(images[k]);
+    }
+    filter->Update();
+    EXPECT_EQ(ITK_NULLPTR, filter->GetIndexOutput());
+
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(NaryMaximumAbsoluteValueImageFilter, IndexOutputIsFirstInputWithTheMaximum) {
+    std::vector<ImageType::Pointer> images = createImages(5);
+
+    FilterType::Pointer filter = FilterType::New();
+    for (size_t k = 0; k < images.size(); ++k) {
+        filter->SetInput(k, images[k]);
+    }
+    filter->GenerateIndexOutputOn();
+    filter->Update();
+    ASSERT_NE(ITK_NULLPTR, filter->GetIndexOutput());
+
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<IndexImageType> it(filter->GetIndexOutput(),
+                                                     filter->GetIndexOutput()->GetBufferedRegion());
+    for (; !ot.IsAtEnd(); ++ot, ++it) {
+        const ImageType::IndexType index = ot.GetIndex();
+        size_t first = 0;
+        for (size_t k = 1; k < images.size(); ++k) {
+            if (std::fabs(images[k]->GetPixel(index)) > std::fabs(images[first]->GetPixel(index))) {
+                first = k;
+            }
+        }
+        ASSERT_EQ(first, it.Get()) << "at " << index;
+        ASSERT_EQ(images[first]->GetPixel(index), ot.Get()) << "at " << index;
+    }
+}
+
+TEST(NaryMaximumAbsoluteValueImageFilter, InPlaceWritesIntoFirstInput) {
+    std::vector<ImageType::Pointer> images = createImages(3);
+    ImageType::Pointer expected = reference(createImages(3));
+    const float *buffer = images[0]->GetBufferPointer();
+
+    FilterType::Pointer filter = FilterType::New();
+    for (size_t k = 0; k < images.size(); ++k) {
+        filter->SetInput(k, images[k]);
+    }
+    filter->InPlaceOn();
+    filter->GenerateIndexOutputOn();
+    filter->Update();
+    EXPECT_EQ(buffer, filter->GetOutput()->GetBufferPointer());
+
+    itk::ImageRegionConstIterator<ImageType> et(expected, expected->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    for (; !et.IsAtEnd(); ++et, ++ot) {
+        ASSERT_EQ(et.Get(), ot.Get()) << "at " << et.GetIndex();
+    }
+}
+
+TEST(NaryMaximumAbsoluteValueImageFilter, SingleInputIsCopied) {
+    ImageType::Pointer image = createImage(1);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->GenerateIndexOutputOn();
+    filter->Update();
+
+    itk::ImageRegionConstIterator<ImageType> it(image, image->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<IndexImageType> nt(filter->GetIndexOutput(),
+                                                     filter->GetIndexOutput()->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it, ++ot, ++nt) {
+        ASSERT_EQ(it.Get(), ot.Get());
+        ASSERT_EQ(0, nt.Get());
+    }
+}
+
+TEST(NaryMaximumAbsoluteValueImageFilter, TooManyInputsForTheIndexPixelType) {
+    ImageType::Pointer image = createImage(1);
+
+    FilterType::Pointer filter = FilterType::New();
+    for (unsigned int k = 0; k < 257; ++k) {
+        filter->SetInput(k, image);
+    }
+    filter->GenerateIndexOutputOn();
+    EXPECT_THROW(filter->Update(), itk::ExceptionObject);
+
+    // without the index output any number of inputs is fine
+    filter->GenerateIndexOutputOff();
+    EXPECT_NO_THROW(filter->Update());
+}
@@ -0,0 +1,66 @@
+#include <sstream>
+#include "gtest/gtest.h"
+
+#include "PerformanceTelemetry.h"
+
+TEST(PerformanceTelemetry, RecordsStages) {
+    itk::PerformanceTelemetry::Pointer telemetry = itk::PerformanceTelemetry::New();
+    EXPECT_EQ(0u, telemetry->GetStages().size());
+
+    telemetry->StartStage("outer");
+    telemetry->StartStage("inner");
+    volatile double sum = 0;
+    for (int i = 0; i < 1000000; ++i) {
+        sum += i;
+    }
+    telemetry->StopStage("inner", 1000, 4000, 2);
+    telemetry->StopStage("outer", 2000, 8000, 4);
+
+    // records are kept in the order the stages finish
+    ASSERT_EQ(2u, telemetry->GetStages().size());
+    const itk::PerformanceTelemetry::StageRecord &inner = telemetry->GetStages()[0];
+    const itk::PerformanceTelemetry::StageRecord &outer = telemetry->GetStages()[1];
+    EXPECT_EQ("inner", inner.Name);
+    EXPECT_EQ("outer", outer.Name);
+    EXPECT_EQ(1000u, inner.NumberOfVoxels);
+    EXPECT_EQ(4000u, inner.NumberOfBytes);
+    EXPECT_EQ(2u, inner.NumberOfThreads);
+    EXPECT_GE(inner.WallTime, 0);
+    EXPECT_GE(inner.CPUTime, 0);
+    EXPECT_GE(outer.WallTime, inner.WallTime);
+    if (inner.WallTime > 0) {
+        EXPECT_DOUBLE_EQ(1000 / inner.WallTime, inner.GetVoxelsPerSecond());
+    }
+
+    telemetry->Clear();
+    EXPECT_EQ(0u, telemetry->GetStages().size());
+}
+
+TEST(PerformanceTelemetry, StopWithoutStartIsIgnored) {
+    itk::PerformanceTelemetry::Pointer telemetry = itk::PerformanceTelemetry::New();
+    telemetry->SetGlobalWarningDisplay(false);
+    telemetry->StopStage("never started", 1, 1, 1);
+    EXPECT_EQ(0u, telemetry->GetStages().size());
+}
+
+TEST(PerformanceTelemetry, WritesJSON) {
+    itk::PerformanceTelemetry::Pointer telemetry = itk::PerformanceTelemetry::New();
+
+    std::ostringstream empty;
+    telemetry->WriteJSON(empty);
+    EXPECT_EQ("{\n  \"stages\": []\n}\n", empty.str());
+
+    telemetry->StartStage("sigma 0.75: \"hessian\"");
+    telemetry->StopStage("sigma 0.75: \"hessian\"", 27, 648, 1);
+
+    std::ostringstream json;
+    telemetry->WriteJSON(json);
+    const std::string s = json.str();
+    EXPECT_NE(std::string::npos, s.find("\"name\": \"sigma 0.75: \\\"hessian\\\"\""));
+    EXPECT_NE(std::string::npos, s.find("\"wall_time_s\": "));
+    EXPECT_NE(std::string::npos, s.find("\"cpu_time_s\": "));
+    EXPECT_NE(std::string::npos, s.find("\"threads\": 1"));
+    EXPECT_NE(std::string::npos, s.find("\"bytes\": 648"));
+    EXPECT_NE(std::string::npos, s.find("\"voxels\": 27"));
+    EXPECT_NE(std::string::npos, s.find("\"voxels_per_s\": "));
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// exact quantile with the rank definition of the sketch
+double exactQuantile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(q * (values.size() - 1))];
+}
+
+TEST(QuantileSketch, Empty) {
+    itk::QuantileSketch sketch;
+    EXPECT_EQ(0u, sketch.GetCount());
+    EXPECT_EQ(0.0, sketch.Quantile(0.99));
+}
+
+TEST(QuantileSketch, RelativeAccuracy) {
+    std::mt19937 generator(11);
+    std::lognormal_distribution<double> distribution(3.0, 2.0);
+    std::vector<double> values(100000);
+    itk::QuantileSketch sketch(0.01);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = distribution(generator);
+        sketch.Insert(values[i]);
+    }
+
+    ASSERT_EQ(values.size(), sketch.GetCount());
+    const double quantiles[] = {0.0, 0.01, 0.5, 0.9, 0.99, 0.999, 1.0};
+    for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); ++i) {
+        const double exact = exactQuantile(values, quantiles[i]);
+        EXPECT_NEAR(exact, sketch.Quantile(quantiles[i]), 0.01 * exact) << "quantile " << quantiles[i];
+    }
+}
+
+TEST(QuantileSketch, OutlierDoesNotMoveHighPercentile) {
+    itk::QuantileSketch sketch(0.01);
+    for (unsigned int i = 1; i <= 10000; ++i) {
+        sketch.Insert(i);
+    }
+    sketch.Insert(1e9); // e.g. a metal implant
+
+    EXPECT_NEAR(9901, sketch.Quantile(0.99), 0.01 * 9901);
+    EXPECT_NEAR(1e9, sketch.Quantile(1.0), 0.01 * 1e9);
+}
+
+TEST(QuantileSketch, ZeroBucket) {
+    itk::QuantileSketch sketch(0.01, 1e-6);
+    for (unsigned int i = 0; i < 90; ++i) {
+        sketch.Insert(0.0);
+    }
+    for (unsigned int i = 0; i < 10; ++i) {
+        sketch.Insert(5.0);
+    }
+
+    EXPECT_EQ(0.0, sketch.Quantile(0.5));
+    EXPECT_NEAR(5.0, sketch.Quantile(0.95), 0.05);
+}
+
+TEST(QuantileSketch, MergeEqualsSingleSketch) {
+    std::mt19937 generator(5);
+    std::exponential_distribution<double> distribution(0.01);
+    itk::QuantileSketch single(0.01);
+    std::vector<itk::QuantileSketch> perThread(4, itk::QuantileSketch(0.01));
+    for (unsigned int i = 0; i < 40000; ++i) {
+        const double value = distribution(generator);
+        single.Insert(value);
+        perThread[i % perThread.size()].Insert(value);
+    }
+
+    itk::QuantileSketch merged(0.01);
+    for (size_t i = 0; i < perThread.size(); ++i) {
+        merged.Merge(perThread[i]);
+    }
+
+    EXPECT_EQ(single.GetCount(), merged.GetCount());
+    EXPECT_EQ(single.GetNumberOfBuckets(), merged.GetNumberOfBuckets());
+    const double quantiles[] = {0.1, 0.5, 0.95, 0.99};
+    for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); ++i) {
+        EXPECT_EQ(single.Quantile(quantiles[i]), merged.Quantile(quantiles[i]));
+    }
+}
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkHessianRecursiveGaussianImageFilter.h"
+#include "SharedPassHessianRecursiveGaussianImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::HessianRecursiveGaussianImageFilter<ImageType> ReferenceFilterType;
+typedef itk::SharedPassHessianRecursiveGaussianImageFilter<ImageType> SharedPassFilterType;
+
+// random image with some structure, anisotropic spacing and a non-cubic size
+ImageType::Pointer createImage() {
+    ImageType::Pointer image = ImageType::New();
+    ImageType::SizeType size = {{23, 17, 19}};
+    ImageType::RegionType region(size);
+    image->SetRegions(region);
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.7;
+    spacing[1] = 1.0;
+    spacing[2] = 1.3;
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> noise(-50, 50);
+    itk::ImageRegionIterator<ImageType> it(image, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
+        const ImageType::IndexType idx = it.GetIndex();
+        const float sheet = std::fabs(idx[0] - 11.0f) < 1.5f ? 1000.0f : 0.0f;
+        it.Set(sheet + 10.0f * idx[1] * idx[2] + noise(generator));
+    }
+    return image;
+}
+
+void compareWithReference(double sigma) {
+    ImageType::Pointer image = createImage();
+
+    ReferenceFilterType::Pointer reference = ReferenceFilterType::New();
+    reference->SetInput(image);
+    reference->SetSigma(sigma);
+    reference->Update();
+
+    SharedPassFilterType::Pointer sharedPass = SharedPassFilterType::New();
+    sharedPass->SetInput(image);
+    sharedPass->SetSigma(sigma);
+    sharedPass->Update();
+
+    ASSERT_EQ(reference->GetOutput()->GetLargestPossibleRegion(), sharedPass->GetOutput()->GetLargestPossibleRegion());
+
+    // largest magnitude per component, the intermediates are float so compare relative to it
+    double maximum = 0;
+    itk::ImageRegionConstIterator<ReferenceFilterType::OutputImageType> rt(reference->GetOutput(), reference->GetOutput()->GetBufferedRegion());
+    for (; !rt.IsAtEnd(); ++rt) {
+        for (unsigned int i = 0; i < 6; ++i) {
+            maximum = std::max(maximum, std::fabs(static_cast<double>(rt.Get()[i])));
+        }
+    }
+    ASSERT_GT(maximum, 0);
+
+    itk::ImageRegionConstIterator<SharedPassFilterType::OutputImageType> st(sharedPass->GetOutput(), sharedPass->GetOutput()->GetBufferedRegion());
+    for (rt.GoToBegin(); !rt.IsAtEnd(); ++rt, ++st) {
+        for (unsigned int row = 0; row < 3; ++row) {
+            for (unsigned int column = row; column < 3; ++column) {
+                ASSERT_NEAR(rt.Get()(row, column), st.Get()(row, column), 1e-4 * maximum)
+                                            << "component (" << row << "," << column << ") at " << rt.GetIndex();
+            }
+        }
+    }
+}
+
+TEST(SharedPassHessianRecursiveGaussianImageFilter, MatchesHessianRecursiveGaussianSigma1) {
+    compareWithReference(1.0);
+}
+
+TEST(SharedPassHessianRecursiveGaussianImageFilter, MatchesHessianRecursiveGaussianSigma075) {
+    compareWithReference(0.75);
+}
+
+TEST(SharedPassHessianRecursiveGaussianImageFilter, MatchesHessianRecursiveGaussianSigma25) {
+    compareWithReference(2.5);
+}
+
+TEST(SharedPassHessianRecursiveGaussianImageFilter, NumberOfPasses) {
+    SharedPassFilterType::Pointer sharedPass = SharedPassFilterType::New();
+    sharedPass->SetInput(createImage());
+    EXPECT_EQ(0u, sharedPass->GetNumberOfPasses());
+
+    // 3 passes along z, 6 along y and 6 along x instead of 18, again on the next update
+    for (unsigned int i = 0; i < 2; ++i) {
+        sharedPass->SetSigma(1.0 + i);
+        sharedPass->Update();
+        EXPECT_EQ(15u, sharedPass->GetNumberOfPasses());
+        EXPECT_EQ(6u, sharedPass->GetNumberOfPasses(0));
+        EXPECT_EQ(6u, sharedPass->GetNumberOfPasses(1));
+        EXPECT_EQ(3u, sharedPass->GetNumberOfPasses(2));
+    }
+}
+
+TEST(SharedPassHessianRecursiveGaussianImageFilter, NumberOfPassesOutOfRange) {
+    SharedPassFilterType::Pointer sharedPass = SharedPassFilterType::New();
+    EXPECT_THROW(sharedPass->GetNumberOfPasses(3), itk::ExceptionObject);
+}
+
+TEST(SharedPassHessianRecursiveGaussianImageFilter, MatchesHessianRecursiveGaussian2D) {
+    typedef itk::Image<float, 2> ImageType2D;
+    typedef itk::HessianRecursiveGaussianImageFilter<ImageType2D> ReferenceFilterType2D;
+    typedef itk::SharedPassHessianRecursiveGaussianImageFilter<ImageType2D> SharedPassFilterType2D;
+
+    ImageType2D::Pointer image = ImageType2D::New();
+    ImageType2D::SizeType size = {{23, 17}};
+    image->SetRegions(size);
+    image->Allocate();
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> noise(-50, 50);
+    itk::ImageRegionIterator<ImageType2D> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        const ImageType2D::IndexType idx = it.GetIndex();
+        it.Set((std::abs(idx[0] - 11) <= 1 ? 1000.0f : 0.0f) + 10.0f * idx[1] + noise(generator));
+    }
+
+    ReferenceFilterType2D::Pointer reference = ReferenceFilterType2D::New();
+    reference->SetInput(image);
+    reference->Update();
+    SharedPassFilterType2D::Pointer sharedPass = SharedPassFilterType2D::New();
+    sharedPass->SetInput(image);
+    sharedPass->Update();
+
+    // 3 passes along y and 3 along x, the same as the ITK filter in 2D
+    EXPECT_EQ(3u, sharedPass->GetNumberOfPasses(0));
+    EXPECT_EQ(3u, sharedPass->GetNumberOfPasses(1));
+
+    double maximum = 0;
+    itk::ImageRegionConstIterator<ReferenceFilterType2D::OutputImageType> rt(reference->GetOutput(), reference->GetOutput()->GetBufferedRegion());
+    for (; !rt.IsAtEnd(); ++rt) {
+        for (unsigned int i = 0; i < 3; ++i) {
+            maximum = std::max(maximum, std::fabs(static_cast<double>(rt.Get()[i])));
+        }
+    }
+    itk::ImageRegionConstIterator<SharedPassFilterType2D::OutputImageType> st(sharedPass->GetOutput(), sharedPass->GetOutput()->GetBufferedRegion());
+    for (rt.GoToBegin(); !rt.IsAtEnd(); ++rt, ++st) {
+        for (unsigned int i = 0; i < 3; ++i) {
+            ASSERT_NEAR(rt.Get()[i], st.Get()[i], 1e-4 * maximum) << "component " << i << " at " << rt.GetIndex();
+        }
+    }
+}
@@ -15,7 +15,6 @@ TEST(TraceFunctor, double2x2) {
 
     a(0, 0) = 1.0;
     a(1, 1) = 2.0;
-    trace.SetImageDimension(2);
     InternalPixelType traceValue = trace(a);
     ASSERT_DOUBLE_EQ(traceValue, 3.0);
 
@@ -65,7 +64,6 @@ TEST(TraceFunctor, double3x3) {
     a(0, 0) = 1.0;
     a(1, 1) = 2.0;
     a(2, 2) = 3.0;
-    trace.SetImageDimension(3);
     InternalPixelType traceValue = trace(a);
     ASSERT_DOUBLE_EQ(traceValue, 6.0);
 }
@@ -82,7 +80,6 @@ TEST(TraceFunctor, double99x99) {
         a(index, index) = index;
     }
 
-    trace.SetImageDimension(DIMENSION);
     InternalPixelType traceValue = trace(a);
     ASSERT_DOUBLE_EQ(traceValue, ((DIMENSION - 1) * ((DIMENSION - 1) + 1) / 2));
 }
@@ -97,7 +94,6 @@ TEST(TraceFunctor, int3x3) {
     a(0, 0) = 1;
     a(1, 1) = 2;
     a(2, 2) = 3;
-    trace.SetImageDimension(3);
     InternalPixelType traceValue = trace(a);
     ASSERT_EQ(traceValue, 6);
 }
@@ -112,11 +108,23 @@ TEST(TraceFunctor, float3x3) {
     a(0, 0) = 1.1;
     a(1, 1) = 2.2;
     a(2, 2) = 3.3;
-    trace.SetImageDimension(3);
     InternalPixelType traceValue = trace(a);
     ASSERT_FLOAT_EQ(traceValue, 6.6);
 }
 
+TEST(TraceFunctor, DimensionFromThePixelType) {
+    typedef itk::SymmetricSecondRankTensor<double, 2> MatrixType;
+    typedef itk::Functor::Trace<MatrixType, double> FunctorType;
+    const FunctorType trace;
+    MatrixType a;
+
+    // the dimension is the one of the tensor
+    a(0, 0) = 1.5;
+    a(0, 1) = 7.0;
+    a(1, 1) = -4.0;
+    EXPECT_DOUBLE_EQ(-2.5, trace(a));
+}
+
 TEST(MaximumAbsoluteValueFunctor, BasicTests) {
     typedef itk::Functor::MaximumAbsoluteValue<float, float, float> FunctorType;
     FunctorType functor;
@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+
+#include "SheetnessParameterStatistics.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+typedef itk::SheetnessParameterStatistics StatisticsType;
+
+// eigenvalues with the interface of itk::FixedArray used by SquaredNorm
+struct EigenValues {
+    double Values[3];
+
+    unsigned int Size() const {
+        return 3;
+    }
+
+    double operator[](unsigned int i) const {
+        return Values[i];
+    }
+};
+
+const StatisticsType::OffsetType rowLength = 37;
+const StatisticsType::OffsetType numberOfRows = 120;
+
+std::vector<EigenValues> createEigenValues() {
+    std::mt19937 generator(29);
+    std::normal_distribution<double> value(0, 40);
+    std::vector<EigenValues> eigenValues(rowLength * numberOfRows);
+    for (size_t i = 0; i < eigenValues.size(); ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            eigenValues[i].Values[j] = value(generator);
+        }
+    }
+    return eigenValues;
+}
+
+// the rows are split into segments of segmentLength, handed out to numberOfThreads threads in turn
+void collect(StatisticsType &statistics, const std::vector<EigenValues> &eigenValues, const unsigned char *labels,
+             unsigned int numberOfThreads, StatisticsType::OffsetType segmentLength) {
+    for (unsigned int thread = 0; thread < numberOfThreads; ++thread) {
+        StatisticsType::ThreadStatistics threadStatistics = statistics.GetThreadStatistics(thread);
+        unsigned int segment = 0;
+        for (StatisticsType::OffsetType row = 0; row < numberOfRows; ++row) {
+            for (StatisticsType::OffsetType begin = 0; begin < rowLength; begin += segmentLength, ++segment) {
+                if (segment % numberOfThreads != thread) {
+                    continue;
+                }
+                const StatisticsType::OffsetType end = std::min(begin + segmentLength, rowLength);
+                statistics.InsertSamples(row * rowLength + begin, row * rowLength + end, row * rowLength,
+                                         &eigenValues[0], labels, static_cast<unsigned char>(1), threadStatistics);
+            }
+        }
+        statistics.AddThreadStatistics(thread, threadStatistics);
+    }
+}
+
+TEST(SheetnessParameterStatistics, FullMaximum) {
+    const std::vector<EigenValues> eigenValues = createEigenValues();
+    double maximum = 0;
+    for (size_t i = 0; i < eigenValues.size(); ++i) {
+        maximum = std::max(maximum, StatisticsType::SquaredNorm(eigenValues[i]));
+    }
+
+    StatisticsType statistics;
+    statistics.Initialize(3, false, eigenValues.size(), rowLength, 0, false, 0);
+    collect(statistics, eigenValues, static_cast<const unsigned char *>(0), 3, 10);
+    statistics.Merge(0.5, 0.99);
+
+    EXPECT_EQ(eigenValues.size(), statistics.GetNumberOfSampledPixels());
+    EXPECT_EQ(eigenValues.size(), statistics.GetNumberOfVisitedPixels());
+    EXPECT_DOUBLE_EQ(0.5 * std::sqrt(maximum), statistics.GetC());
+    EXPECT_EQ(0.0, statistics.GetExceedanceFraction());
+}
+
+TEST(SheetnessParameterStatistics, Label) {
+    const std::vector<EigenValues> eigenValues = createEigenValues();
+    std::vector<unsigned char> labels(eigenValues.size());
+    double maximum = 0;
+    StatisticsType::CountType count = 0;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        labels[i] = i % 3 == 0 ? 1 : 0;
+        if (labels[i] == 1) {
+            maximum = std::max(maximum, StatisticsType::SquaredNorm(eigenValues[i]));
+            ++count;
+        }
+    }
+
+    StatisticsType statistics;
+    statistics.Initialize(2, false, eigenValues.size(), rowLength, 0, false, 0);
+    collect(statistics, eigenValues, &labels[0], 2, rowLength);
+    statistics.Merge(1.0, 0.99);
+
+    EXPECT_EQ(count, statistics.GetNumberOfSampledPixels());
+    EXPECT_DOUBLE_EQ(std::sqrt(maximum), statistics.GetC());
+}
+
+TEST(SheetnessParameterStatistics, SampleDoesNotDependOnThreads) {
+    const std::vector<EigenValues> eigenValues = createEigenValues();
+    for (unsigned int random = 0; random < 2; ++random) {
+        StatisticsType single;
+        single.Initialize(1, true, eigenValues.size(), rowLength, 500, random == 1, 7);
+        collect(single, eigenValues, static_cast<const unsigned char *>(0), 1, rowLength);
+        single.Merge(1.0, 0.9);
+
+        StatisticsType split;
+        split.Initialize(4, true, eigenValues.size(), rowLength, 500, random == 1, 7);
+        collect(split, eigenValues, static_cast<const unsigned char *>(0), 4, 9);
+        split.Merge(1.0, 0.9);
+
+        EXPECT_GT(single.GetNumberOfSampledPixels(), 300u) << "random " << random;
+        EXPECT_LT(single.GetNumberOfSampledPixels(), 700u) << "random " << random;
+        EXPECT_EQ(single.GetNumberOfSampledPixels(), split.GetNumberOfSampledPixels()) << "random " << random;
+        EXPECT_EQ(single.GetC(), split.GetC()) << "random " << random;
+        EXPECT_LE(split.GetCLowerBound(), split.GetC());
+        EXPECT_GE(split.GetCUpperBound(), split.GetC());
+        EXPECT_EQ(split.GetNumberOfVisitedPixels(), split.GetNumberOfSampledPixels());
+    }
+}
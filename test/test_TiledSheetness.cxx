@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkHessianRecursiveGaussianImageFilter.h"
+#include "itkSymmetricEigenAnalysisImageFilter.h"
+#include "AutomaticSheetnessParameterEstimationImageFilter.h"
+#include "ModifiedSheetnessImageFilter.h"
+#include "TiledSheetnessImageFilter.h"
+
+#include <cmath>
+#include <random>
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::Image<unsigned char, 3> MaskImageType;
+typedef itk::HessianRecursiveGaussianImageFilter<ImageType> HessianFilterType;
+typedef HessianFilterType::OutputImageType HessianImageType;
+typedef itk::FixedArray<double, 3> EigenValueArrayType;
+typedef itk::Image<EigenValueArrayType, 3> EigenValueImageType;
+typedef itk::SymmetricEigenAnalysisImageFilter<HessianImageType, EigenValueImageType> EigenAnalysisFilterType;
+typedef itk::AutomaticSheetnessParameterEstimationImageFilter<EigenValueImageType, MaskImageType> EstimationFilterType;
+typedef itk::ModifiedSheetnessImageFilter<EigenValueImageType, ImageType> SheetnessFilterType;
+typedef itk::TiledSheetnessImageFilter<ImageType, ImageType, MaskImageType> TiledFilterType;
+
+// plates of different thickness and orientation on a noisy background
+ImageType::Pointer createImage() {
+    ImageType::Pointer image = ImageType::New();
+    ImageType::SizeType size = {{40, 33, 29}};
+    image->SetRegions(size);
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.8;
+    spacing[1] = 1.0;
+    spacing[2] = 1.2;
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    std::mt19937 generator(13);
+    std::normal_distribution<float> noise(0, 30);
+    itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        const ImageType::IndexType idx = it.GetIndex();
+        float value = noise(generator);
+        if (std::abs(idx[0] - 12) <= 1) {
+            value += 1000;
+        }
+        if (std::abs(idx[1] + idx[2] - 35) <= 2) {
+            value += 700;
+        }
+        it.Set(value);
+    }
+    return image;
+}
+
+MaskImageType::Pointer createMask(const ImageType *image) {
+    MaskImageType::Pointer mask = MaskImageType::New();
+    mask->CopyInformation(image);
+    mask->SetRegions(image->GetLargestPossibleRegion());
+    mask->Allocate();
+    itk::ImageRegionIterator<MaskImageType> it(mask, mask->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it) {
+        it.Set(it.GetIndex()[2] > 3 ? 1 : 0);
+    }
+    return mask;
+}
+
+void compareWithPipeline(const TiledFilterType::SizeType &tileSize, double sigma) {
+    ImageType::Pointer image = createImage();
+    MaskImageType::Pointer mask = createMask(image);
+
+    // untiled pipeline of example/ModifiedSheetness
+    HessianFilterType::Pointer hessian = HessianFilterType::New();
+    hessian->SetInput(image);
+    hessian->SetSigma(sigma);
+    EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+    eigen->SetDimension(3);
+    eigen->SetInput(hessian->GetOutput());
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigen->GetOutput());
+    estimation->SetLabelInput(mask);
+    estimation->SetScale(0.05);
+    estimation->Update();
+    SheetnessFilterType::Pointer sheetness = SheetnessFilterType::New();
+    sheetness->SetInput(estimation->GetOutput());
+    sheetness->DetectBrightSheetsOn();
+    sheetness->SetNormalization(0.5);
+    sheetness->SetNoiseNormalization(estimation->GetC());
+    sheetness->Update();
+
+    TiledFilterType::Pointer tiled = TiledFilterType::New();
+    tiled->SetInput(image);
+    tiled->SetLabelInput(mask);
+    tiled->SetSigma(sigma);
+    tiled->SetAlpha(0.5);
+    tiled->SetScale(0.05);
+    tiled->SetTileSize(tileSize);
+    tiled->Update();
+
+    EXPECT_NEAR(estimation->GetC(), tiled->GetC(), 1e-3 * estimation->GetC());
+    EXPECT_GT(tiled->GetNumberOfTiles(), 1u);
+
+    itk::ImageRegionConstIterator<ImageType> st(sheetness->GetOutput(), sheetness->GetOutput()->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> tt(tiled->GetOutput(), tiled->GetOutput()->GetBufferedRegion());
+    for (; !st.IsAtEnd(); ++st, ++tt) {
+        ASSERT_NEAR(st.Get(), tt.Get(), 1e-3) << "at " << st.GetIndex();
+    }
+}
+
+TEST(TiledSheetnessImageFilter, MatchesPipelineCubicTiles) {
+    TiledFilterType::SizeType tileSize = {{8, 8, 8}};
+    compareWithPipeline(tileSize, 1.0);
+}
+
+TEST(TiledSheetnessImageFilter, MatchesPipelineUnevenTiles) {
+    TiledFilterType::SizeType tileSize = {{16, 7, 29}};
+    compareWithPipeline(tileSize, 0.75);
+}
+
+TEST(TiledSheetnessImageFilter, MatchesPipelineSingleVoxelRemainder) {
+    // 40 x 33 x 29 leaves a 1 voxel tile at the border of every dimension, the small sigma gives the minimum halo
+    TiledFilterType::SizeType tileSize = {{13, 32, 14}};
+    compareWithPipeline(tileSize, 0.25);
+}
+
+TEST(TiledSheetnessImageFilter, MatchesPipelineLargeSigma) {
+    TiledFilterType::SizeType tileSize = {{12, 12, 12}};
+    compareWithPipeline(tileSize, 2.0);
+}
+
+// C of the untiled estimation and of the tiled filter, with and without the label image
+void compareC(const MaskImageType *mask, bool useQuantile, double tolerance) {
+    ImageType::Pointer image = createImage();
+
+    HessianFilterType::Pointer hessian = HessianFilterType::New();
+    hessian->SetInput(image);
+    hessian->SetSigma(1.0);
+    EigenAnalysisFilterType::Pointer eigen = EigenAnalysisFilterType::New();
+    eigen->SetDimension(3);
+    eigen->SetInput(hessian->GetOutput());
+    EstimationFilterType::Pointer estimation = EstimationFilterType::New();
+    estimation->SetInput(eigen->GetOutput());
+    if (mask != ITK_NULLPTR) {
+        estimation->SetLabelInput(mask);
+    }
+    estimation->SetScale(0.05);
+    estimation->SetUseQuantile(useQuantile);
+    estimation->SetQuantile(0.9);
+    estimation->Update();
+
+    TiledFilterType::Pointer tiled = TiledFilterType::New();
+    tiled->SetInput(image);
+    if (mask != ITK_NULLPTR) {
+        tiled->SetLabelInput(mask);
+    }
+    tiled->SetSigma(1.0);
+    tiled->SetScale(0.05);
+    tiled->SetUseQuantile(useQuantile);
+    tiled->SetQuantile(0.9);
+    TiledFilterType::SizeType tileSize = {{8, 8, 8}};
+    tiled->SetTileSize(tileSize);
+    tiled->Update();
+
+    EXPECT_GT(estimation->GetC(), 0);
+    EXPECT_NEAR(estimation->GetC(), tiled->GetC(), tolerance * estimation->GetC());
+}
+
+TEST(TiledSheetnessImageFilter, MaximumWithoutLabelMatchesTheEstimation) {
+    compareC(ITK_NULLPTR, false, 1e-3);
+}
+
+TEST(TiledSheetnessImageFilter, QuantileMatchesTheEstimation) {
+    // both sketches guarantee 1% of the rank, the threads insert the norms in a different order
+    compareC(createMask(createImage()), true, 0.05);
+    compareC(ITK_NULLPTR, true, 0.05);
+}